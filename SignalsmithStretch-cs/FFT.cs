@@ -1,4 +1,4 @@
-using System;
+﻿using System;
 using System.Runtime.InteropServices;
 
 namespace Signalsmith
@@ -12,7 +12,7 @@ namespace Signalsmith
 
         public FFT(int size)
         {
-            unsafe { Handle = Native.FFT_Create(size); }
+            unsafe { Handle = Native.FFT_Create((UIntPtr)size); }
         }
 
         ~FFT()
@@ -64,6 +64,31 @@ namespace Signalsmith
             }
         }
 
+        /// <summary>
+        /// Heap bytes held by the native binding for this instance, excluding buffers shared between instances and
+        /// the transform's own tables inside signalsmith-linear.
+        /// </summary>
+        public long MemoryFootprint()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                return (long)(ulong)Native.FFT_MemoryFootprint(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Heap bytes of the read-only buffers currently shared between FFT instances.
+        /// </summary>
+        public static long SharedMemoryFootprint()
+        {
+            return (long)(ulong)Native.FFT_SharedMemoryFootprint();
+        }
+
         public int Steps()
         {
             unsafe 
@@ -172,6 +197,227 @@ namespace Signalsmith
             }
         }
 
+        // Interleaved complex (re, im, re, im, ...) variants, passed to the FFT without any repacking
+
+        /// <summary>
+        /// Transforms several equal-size frames in one native call. Frame f starts at f * strideFrames in every array, and a stride of 0 means Size().
+        /// </summary>
+        public void ProcessBatch(int frames, float[] inputReal, float[] inputImag, float[] outputReal, float[] outputImag, int strideFrames = 0)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inRealPtr = inputReal)
+                fixed (float* inImagPtr = inputImag)
+                fixed (float* outRealPtr = outputReal)
+                fixed (float* outImagPtr = outputImag)
+                {
+                    Native.FFT_ProcBatch(Handle, frames, inRealPtr, inImagPtr, outRealPtr, outImagPtr, (UIntPtr)strideFrames);
+                }
+            }
+        }
+
+        public void InverseProcessBatch(int frames, float[] inputReal, float[] inputImag, float[] outputReal, float[] outputImag, int strideFrames = 0)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inRealPtr = inputReal)
+                fixed (float* inImagPtr = inputImag)
+                fixed (float* outRealPtr = outputReal)
+                fixed (float* outImagPtr = outputImag)
+                {
+                    Native.FFT_InverseProcBatch(Handle, frames, inRealPtr, inImagPtr, outRealPtr, outImagPtr, (UIntPtr)strideFrames);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void ProcessBatch(int frames, ReadOnlySpan<float> inputReal, ReadOnlySpan<float> inputImag, Span<float> outputReal, Span<float> outputImag, int strideFrames = 0)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inRealPtr = inputReal)
+                fixed (float* inImagPtr = inputImag)
+                fixed (float* outRealPtr = outputReal)
+                fixed (float* outImagPtr = outputImag)
+                {
+                    Native.FFT_ProcBatch(Handle, frames, inRealPtr, inImagPtr, outRealPtr, outImagPtr, (UIntPtr)strideFrames);
+                }
+            }
+        }
+
+        public void InverseProcessBatch(int frames, ReadOnlySpan<float> inputReal, ReadOnlySpan<float> inputImag, Span<float> outputReal, Span<float> outputImag, int strideFrames = 0)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inRealPtr = inputReal)
+                fixed (float* inImagPtr = inputImag)
+                fixed (float* outRealPtr = outputReal)
+                fixed (float* outImagPtr = outputImag)
+                {
+                    Native.FFT_InverseProcBatch(Handle, frames, inRealPtr, inImagPtr, outRealPtr, outImagPtr, (UIntPtr)strideFrames);
+                }
+            }
+        }
+#endif
+
+        public void ProcessComplex(float[] interleavedInput, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_ProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void ProcessComplexStep(int step, float[] interleavedInput, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_ProcComplexStep(Handle, (UIntPtr)step, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcessComplex(float[] interleavedInput, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_InverseProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcessComplexStep(int step, float[] interleavedInput, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_InverseProcComplexStep(Handle, (UIntPtr)step, inPtr, outPtr);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void ProcessComplex(Span<float> interleavedInput, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_ProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void ProcessComplexStep(int step, Span<float> interleavedInput, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_ProcComplexStep(Handle, (UIntPtr)step, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcessComplex(Span<float> interleavedInput, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_InverseProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcessComplexStep(int step, Span<float> interleavedInput, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("FFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.FFT_InverseProcComplexStep(Handle, (UIntPtr)step, inPtr, outPtr);
+                }
+            }
+        }
+#endif
+
 #if NET7_0_OR_GREATER
         public void Process(Span<float> inputReal, Span<float> inputImag, Span<float> outputReal, Span<float> outputImag)
         {
@@ -270,11 +516,266 @@ namespace Signalsmith
 #endif
     }
 
+    /// <summary>
+    /// Real-input FFT, producing Size() / 2 + 1 bins (DC to Nyquist inclusive) for about half the cost of a complex FFT.
+    /// </summary>
+    public class RealFFT : IDisposable
+    {
+        public unsafe void* Handle;
+
+        public RealFFT(int size)
+        {
+            if (size < 2)
+            {
+                throw new ArgumentOutOfRangeException(nameof(size));
+            }
+
+            unsafe { Handle = Native.RealFFT_Create((UIntPtr)size); }
+        }
+
+        ~RealFFT()
+        {
+            Release();
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        public void Release()
+        {
+            unsafe
+            {
+                if (Handle != null)
+                {
+                    Native.RealFFT_Delete(Handle);
+                    Handle = null;
+                }
+            }
+        }
+
+        public void Resize(int size)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                if (size < 2)
+                {
+                    throw new ArgumentOutOfRangeException(nameof(size));
+                }
+
+                Native.RealFFT_Resize(Handle, (UIntPtr)size);
+            }
+        }
+
+        public int Size()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                return (int)Native.RealFFT_Size(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Heap bytes held by the native binding for this instance, excluding buffers shared between instances.
+        /// </summary>
+        public long MemoryFootprint()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                return (long)(ulong)Native.RealFFT_MemoryFootprint(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Number of output bins, Size() / 2 + 1.
+        /// </summary>
+        public int Bands()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                return (int)Native.RealFFT_Bands(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Transforms Size() real samples into Bands() bins, in separate real/imaginary arrays.
+        /// </summary>
+        public void Process(float[] input, float[] outputReal, float[] outputImag)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inPtr = input)
+                fixed (float* outRealPtr = outputReal)
+                fixed (float* outImagPtr = outputImag)
+                {
+                    Native.RealFFT_Proc(Handle, inPtr, outRealPtr, outImagPtr);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Transforms Size() real samples into Bands() interleaved (real, imaginary) bins.
+        /// </summary>
+        public void ProcessComplex(float[] input, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inPtr = input)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.RealFFT_ProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Transforms Bands() bins back into Size() real samples. Like FFT, the result is not normalised.
+        /// </summary>
+        public void InverseProcess(float[] inputReal, float[] inputImag, float[] output)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inRealPtr = inputReal)
+                fixed (float* inImagPtr = inputImag)
+                fixed (float* outPtr = output)
+                {
+                    Native.RealFFT_InverseProc(Handle, inRealPtr, inImagPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcessComplex(float[] interleavedInput, float[] output)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = output)
+                {
+                    Native.RealFFT_InverseProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void Process(ReadOnlySpan<float> input, Span<float> outputReal, Span<float> outputImag)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inPtr = input)
+                fixed (float* outRealPtr = outputReal)
+                fixed (float* outImagPtr = outputImag)
+                {
+                    Native.RealFFT_Proc(Handle, inPtr, outRealPtr, outImagPtr);
+                }
+            }
+        }
+
+        public void ProcessComplex(ReadOnlySpan<float> input, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inPtr = input)
+                fixed (float* outPtr = interleavedOutput)
+                {
+                    Native.RealFFT_ProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcess(ReadOnlySpan<float> inputReal, ReadOnlySpan<float> inputImag, Span<float> output)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inRealPtr = inputReal)
+                fixed (float* inImagPtr = inputImag)
+                fixed (float* outPtr = output)
+                {
+                    Native.RealFFT_InverseProc(Handle, inRealPtr, inImagPtr, outPtr);
+                }
+            }
+        }
+
+        public void InverseProcessComplex(ReadOnlySpan<float> interleavedInput, Span<float> output)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("RealFFT");
+                }
+
+                fixed (float* inPtr = interleavedInput)
+                fixed (float* outPtr = output)
+                {
+                    Native.RealFFT_InverseProcComplex(Handle, inPtr, outPtr);
+                }
+            }
+        }
+#endif
+    }
+
     internal static partial class Native
     {
 #if NET7_0_OR_GREATER
         [LibraryImport(DllName, EntryPoint = "FFT_Create")]
-        public static unsafe partial void* FFT_Create(int size);
+        public static unsafe partial void* FFT_Create(UIntPtr size);
 
         [LibraryImport(DllName, EntryPoint = "FFT_Delete")]
         public static unsafe partial void FFT_Delete(void* fft);
@@ -311,9 +812,63 @@ namespace Signalsmith
 
         [LibraryImport(DllName, EntryPoint = "FFT_InverseProcSplitStep")]
         public static unsafe partial void FFT_InverseProcSplitStep(void* fft, UIntPtr step, float* inputReal, float* inputImag, float* outputReal, float* outputImag);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_ProcComplex")]
+        public static unsafe partial void FFT_ProcComplex(void* fft, float* interleavedInput, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_ProcComplexStep")]
+        public static unsafe partial void FFT_ProcComplexStep(void* fft, UIntPtr step, float* interleavedInput, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_InverseProcComplex")]
+        public static unsafe partial void FFT_InverseProcComplex(void* fft, float* interleavedInput, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_InverseProcComplexStep")]
+        public static unsafe partial void FFT_InverseProcComplexStep(void* fft, UIntPtr step, float* interleavedInput, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_ProcBatch")]
+        public static unsafe partial void FFT_ProcBatch(void* fft, int frames, float* inputReal, float* inputImag, float* outputReal, float* outputImag, UIntPtr strideFrames);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_InverseProcBatch")]
+        public static unsafe partial void FFT_InverseProcBatch(void* fft, int frames, float* inputReal, float* inputImag, float* outputReal, float* outputImag, UIntPtr strideFrames);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_Create")]
+        public static unsafe partial void* RealFFT_Create(UIntPtr size);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_Delete")]
+        public static unsafe partial void RealFFT_Delete(void* fft);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_Resize")]
+        public static unsafe partial void RealFFT_Resize(void* fft, UIntPtr size);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_Size")]
+        public static unsafe partial UIntPtr RealFFT_Size(void* fft);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_Bands")]
+        public static unsafe partial UIntPtr RealFFT_Bands(void* fft);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_Proc")]
+        public static unsafe partial void RealFFT_Proc(void* fft, float* input, float* outputReal, float* outputImag);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_ProcComplex")]
+        public static unsafe partial void RealFFT_ProcComplex(void* fft, float* input, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_InverseProc")]
+        public static unsafe partial void RealFFT_InverseProc(void* fft, float* inputReal, float* inputImag, float* output);
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_InverseProcComplex")]
+        public static unsafe partial void RealFFT_InverseProcComplex(void* fft, float* interleavedInput, float* output);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_MemoryFootprint")]
+        public static unsafe partial UIntPtr FFT_MemoryFootprint(void* fft);
+
+        [LibraryImport(DllName, EntryPoint = "FFT_SharedMemoryFootprint")]
+        public static unsafe partial UIntPtr FFT_SharedMemoryFootprint();
+
+        [LibraryImport(DllName, EntryPoint = "RealFFT_MemoryFootprint")]
+        public static unsafe partial UIntPtr RealFFT_MemoryFootprint(void* fft);
 #else
         [DllImport(DllName, EntryPoint = "FFT_Create")]
-        public static extern unsafe void* FFT_Create(int size);
+        public static extern unsafe void* FFT_Create(UIntPtr size);
 
         [DllImport(DllName, EntryPoint = "FFT_Delete")]
         public static extern unsafe void FFT_Delete(void* fft);
@@ -350,6 +905,60 @@ namespace Signalsmith
 
         [DllImport(DllName, EntryPoint = "FFT_InverseProcSplitStep")]
         public static extern unsafe void FFT_InverseProcSplitStep(void* fft, UIntPtr step, float* inputReal, float* inputImag, float* outputReal, float* outputImag);
+
+        [DllImport(DllName, EntryPoint = "FFT_ProcComplex")]
+        public static extern unsafe void FFT_ProcComplex(void* fft, float* interleavedInput, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "FFT_ProcComplexStep")]
+        public static extern unsafe void FFT_ProcComplexStep(void* fft, UIntPtr step, float* interleavedInput, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "FFT_InverseProcComplex")]
+        public static extern unsafe void FFT_InverseProcComplex(void* fft, float* interleavedInput, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "FFT_InverseProcComplexStep")]
+        public static extern unsafe void FFT_InverseProcComplexStep(void* fft, UIntPtr step, float* interleavedInput, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "FFT_ProcBatch")]
+        public static extern unsafe void FFT_ProcBatch(void* fft, int frames, float* inputReal, float* inputImag, float* outputReal, float* outputImag, UIntPtr strideFrames);
+
+        [DllImport(DllName, EntryPoint = "FFT_InverseProcBatch")]
+        public static extern unsafe void FFT_InverseProcBatch(void* fft, int frames, float* inputReal, float* inputImag, float* outputReal, float* outputImag, UIntPtr strideFrames);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_Create")]
+        public static extern unsafe void* RealFFT_Create(UIntPtr size);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_Delete")]
+        public static extern unsafe void RealFFT_Delete(void* fft);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_Resize")]
+        public static extern unsafe void RealFFT_Resize(void* fft, UIntPtr size);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_Size")]
+        public static extern unsafe UIntPtr RealFFT_Size(void* fft);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_Bands")]
+        public static extern unsafe UIntPtr RealFFT_Bands(void* fft);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_Proc")]
+        public static extern unsafe void RealFFT_Proc(void* fft, float* input, float* outputReal, float* outputImag);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_ProcComplex")]
+        public static extern unsafe void RealFFT_ProcComplex(void* fft, float* input, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_InverseProc")]
+        public static extern unsafe void RealFFT_InverseProc(void* fft, float* inputReal, float* inputImag, float* output);
+
+        [DllImport(DllName, EntryPoint = "RealFFT_InverseProcComplex")]
+        public static extern unsafe void RealFFT_InverseProcComplex(void* fft, float* interleavedInput, float* output);
+
+        [DllImport(DllName, EntryPoint = "FFT_MemoryFootprint")]
+        public static extern unsafe UIntPtr FFT_MemoryFootprint(void* fft);
+
+        [DllImport(DllName, EntryPoint = "FFT_SharedMemoryFootprint")]
+        public static extern unsafe UIntPtr FFT_SharedMemoryFootprint();
+
+        [DllImport(DllName, EntryPoint = "RealFFT_MemoryFootprint")]
+        public static extern unsafe UIntPtr RealFFT_MemoryFootprint(void* fft);
 #endif
     }
 }
\ No newline at end of file
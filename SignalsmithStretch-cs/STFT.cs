@@ -10,6 +10,9 @@ namespace Signalsmith
     {
         public unsafe void* Handle;
 
+        // Hot-path entry points for this instance's variant, bound once so calls skip the native split/plain branch
+        private STFTFunctions functions;
+
         public STFT() : this(false)
         {
         }
@@ -19,6 +22,7 @@ namespace Signalsmith
             unsafe
             {
                 Handle = Native.STFT_Create(splitComputation);
+                functions = splitComputation ? STFTFunctions.Split : STFTFunctions.Plain;
 
                 if (Handle == null)
                 {
@@ -89,6 +93,19 @@ namespace Signalsmith
             }
         }
 
+        public UIntPtr DefaultInterval()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                return Native.STFT_DefaultInterval(Handle);
+            }
+        }
+
         public UIntPtr Bands()
         {
             unsafe
@@ -102,6 +119,39 @@ namespace Signalsmith
             }
         }
 
+        /// <summary>
+        /// Heap bytes held by the native binding for this instance, not counting the transform buffers inside signalsmith-linear.
+        /// </summary>
+        public long MemoryFootprint()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                return (long)(ulong)Native.STFT_MemoryFootprint(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Allocations made by the native binding for this STFT since its last Configure.
+        /// Nonzero after setup means processing allocated.
+        /// </summary>
+        public long AllocationsSinceConfigure()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                return (long)(ulong)Native.STFT_AllocationsSinceConfigure(Handle);
+            }
+        }
+
         public void Reset()
         {
             unsafe
@@ -126,7 +176,7 @@ namespace Signalsmith
 
                 fixed (float* inputPtr = inputArray)
                 {
-                    Native.STFT_WriteInput(Handle, channel, offset, length, inputPtr);
+                    functions.WriteInput(Handle, channel, offset, length, inputPtr);
                 }
             }
         }
@@ -143,7 +193,7 @@ namespace Signalsmith
 
                 fixed (float* inputPtr = inputSpan)
                 {
-                    Native.STFT_WriteInput(Handle, channel, offset, length, inputPtr);
+                    functions.WriteInput(Handle, channel, offset, length, inputPtr);
                 }
             }
         }
@@ -156,7 +206,7 @@ namespace Signalsmith
                 throw new ObjectDisposedException("STFT");
             }
 
-            Native.STFT_WriteInput(Handle, channel, offset, length, inputPtr);
+            functions.WriteInput(Handle, channel, offset, length, inputPtr);
         }
 
         public void ReadOutput(UIntPtr channel, UIntPtr offset, UIntPtr length, float[] outputArray)
@@ -170,7 +220,7 @@ namespace Signalsmith
 
                 fixed (float* outputPtr = outputArray)
                 {
-                    Native.STFT_ReadOutput(Handle, channel, offset, length, outputPtr);
+                    functions.ReadOutput(Handle, channel, offset, length, outputPtr);
                 }
             }
         }
@@ -187,7 +237,7 @@ namespace Signalsmith
 
                 fixed (float* outputPtr = outputSpan)
                 {
-                    Native.STFT_ReadOutput(Handle, channel, offset, length, outputPtr);
+                    functions.ReadOutput(Handle, channel, offset, length, outputPtr);
                 }
             }
         }
@@ -200,7 +250,7 @@ namespace Signalsmith
                 throw new ObjectDisposedException("STFT");
             }
 
-            Native.STFT_ReadOutput(Handle, channel, offset, length, outputPtr);
+            functions.ReadOutput(Handle, channel, offset, length, outputPtr);
         }
 
         public void MoveInput(UIntPtr samples, bool clearMovedRegion)
@@ -212,7 +262,7 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_MoveInput(Handle, samples, clearMovedRegion);
+                functions.MoveInput(Handle, samples, clearMovedRegion);
             }
         }
 
@@ -238,7 +288,7 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_Analyse(Handle, sampleInPast);
+                functions.Analyse(Handle, sampleInPast);
             }
         }
 
@@ -251,7 +301,7 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_Synthesise(Handle);
+                functions.Synthesise(Handle);
             }
         }
 
@@ -286,6 +336,215 @@ namespace Signalsmith
         }
 #endif
 
+        /// <summary>
+        /// Live pointer to a channel's spectrum, as Bands() interleaved (real, imaginary) pairs. Valid until the next Configure.
+        /// </summary>
+        public unsafe float* SpectrumPtr(UIntPtr channel)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            return functions.SpectrumPtr(Handle, channel);
+        }
+
+        /// <summary>
+        /// Copies a channel's whole spectrum (Bands() values per array) into caller-supplied buffers.
+        /// </summary>
+        public void ReadSpectrum(UIntPtr channel, float[] outputReal, float[] outputImag)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* realPtr = outputReal)
+                fixed (float* imagPtr = outputImag)
+                {
+                    functions.ReadSpectrum(Handle, channel, realPtr, imagPtr);
+                }
+            }
+        }
+
+        public void ReadSpectrumInterleaved(UIntPtr channel, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* outputPtr = interleavedOutput)
+                {
+                    functions.ReadSpectrumInterleaved(Handle, channel, outputPtr);
+                }
+            }
+        }
+
+        public void WriteSpectrum(UIntPtr channel, float[] inputReal, float[] inputImag)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* realPtr = inputReal)
+                fixed (float* imagPtr = inputImag)
+                {
+                    functions.WriteSpectrum(Handle, channel, realPtr, imagPtr);
+                }
+            }
+        }
+
+        public void WriteSpectrumInterleaved(UIntPtr channel, float[] interleavedInput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* inputPtr = interleavedInput)
+                {
+                    functions.WriteSpectrumInterleaved(Handle, channel, inputPtr);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        /// <summary>
+        /// Live view of a channel's spectrum, as Bands() interleaved (real, imaginary) pairs. Valid until the next Configure.
+        /// </summary>
+        public Span<float> SpectrumSpan(UIntPtr channel)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                return new Span<float>(functions.SpectrumPtr(Handle, channel), (int)Native.STFT_Bands(Handle) * 2);
+            }
+        }
+
+        public void ReadSpectrum(UIntPtr channel, Span<float> outputReal, Span<float> outputImag)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* realPtr = outputReal)
+                fixed (float* imagPtr = outputImag)
+                {
+                    functions.ReadSpectrum(Handle, channel, realPtr, imagPtr);
+                }
+            }
+        }
+
+        public void ReadSpectrumInterleaved(UIntPtr channel, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* outputPtr = interleavedOutput)
+                {
+                    functions.ReadSpectrumInterleaved(Handle, channel, outputPtr);
+                }
+            }
+        }
+
+        public void WriteSpectrum(UIntPtr channel, ReadOnlySpan<float> inputReal, ReadOnlySpan<float> inputImag)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* realPtr = inputReal)
+                fixed (float* imagPtr = inputImag)
+                {
+                    functions.WriteSpectrum(Handle, channel, realPtr, imagPtr);
+                }
+            }
+        }
+
+        public void WriteSpectrumInterleaved(UIntPtr channel, ReadOnlySpan<float> interleavedInput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* inputPtr = interleavedInput)
+                {
+                    functions.WriteSpectrumInterleaved(Handle, channel, inputPtr);
+                }
+            }
+        }
+#endif
+
+        /// <summary>
+        /// Runs the whole STFT hop schedule over a block of interleaved audio in one native call. At each hop the input
+        /// is analysed, the callback (if not null) edits the spectra in place, and the result is synthesised into the output.
+        /// The callback receives (userData, spectra, channels, bands), each spectrum being bands interleaved (real, imaginary) pairs.
+        /// Processes min(inputLength, outputLength) samples per channel, and zeroes any output beyond that.
+        /// </summary>
+        public void ProcessBlock(float[] input, int inputLength, float[] output, int outputLength, IntPtr callback, IntPtr userData)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+#if NET7_0_OR_GREATER
+                    functions.ProcessBlock(Handle, inputPtr, (UIntPtr)inputLength, outputPtr, (UIntPtr)outputLength, (delegate* unmanaged<void*, float**, int, int, void>)callback, (void*)userData);
+#else
+                    functions.ProcessBlock(Handle, inputPtr, (UIntPtr)inputLength, outputPtr, (UIntPtr)outputLength, callback, (void*)userData);
+#endif
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public unsafe void ProcessBlock(ReadOnlySpan<float> input, int inputLength, Span<float> output, int outputLength, delegate* unmanaged<void*, float**, int, int, void> callback, void* userData)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            fixed (float* inputPtr = input)
+            fixed (float* outputPtr = output)
+            {
+                functions.ProcessBlock(Handle, inputPtr, (UIntPtr)inputLength, outputPtr, (UIntPtr)outputLength, callback, userData);
+            }
+        }
+#endif
+
         public float[] AnalysisWindow()
         {
             unsafe
@@ -470,7 +729,7 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_AnalyseStep(Handle, step, sampleInPast);
+                functions.AnalyseStep(Handle, step, sampleInPast);
             }
         }
 
@@ -483,7 +742,7 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_SynthesiseStep(Handle, step);
+                functions.SynthesiseStep(Handle, step);
             }
         }
 
@@ -537,7 +796,7 @@ namespace Signalsmith
 
                 fixed (float* outputPtr = outputArray)
                 {
-                    Native.STFT_AddOutput(Handle, channel, offset, length, outputPtr);
+                    functions.AddOutput(Handle, channel, offset, length, outputPtr);
                 }
             }
         }
@@ -554,7 +813,7 @@ namespace Signalsmith
 
                 fixed (float* outputPtr = outputSpan)
                 {
-                    Native.STFT_AddOutput(Handle, channel, offset, length, outputPtr);
+                    functions.AddOutput(Handle, channel, offset, length, outputPtr);
                 }
             }
         }
@@ -567,7 +826,7 @@ namespace Signalsmith
                 throw new ObjectDisposedException("STFT");
             }
 
-            Native.STFT_AddOutput(Handle, channel, offset, length, outputPtr);
+            functions.AddOutput(Handle, channel, offset, length, outputPtr);
         }
 
         public void ReplaceOutput(UIntPtr channel, UIntPtr offset, UIntPtr length, float[] outputArray)
@@ -581,7 +840,7 @@ namespace Signalsmith
 
                 fixed (float* outputPtr = outputArray)
                 {
-                    Native.STFT_ReplaceOutput(Handle, channel, offset, length, outputPtr);
+                    functions.ReplaceOutput(Handle, channel, offset, length, outputPtr);
                 }
             }
         }
@@ -598,7 +857,7 @@ namespace Signalsmith
 
                 fixed (float* outputPtr = outputSpan)
                 {
-                    Native.STFT_ReplaceOutput(Handle, channel, offset, length, outputPtr);
+                    functions.ReplaceOutput(Handle, channel, offset, length, outputPtr);
                 }
             }
         }
@@ -611,10 +870,13 @@ namespace Signalsmith
                 throw new ObjectDisposedException("STFT");
             }
 
-            Native.STFT_ReplaceOutput(Handle, channel, offset, length, outputPtr);
+            functions.ReplaceOutput(Handle, channel, offset, length, outputPtr);
         }
 
-        public void MoveOutput(UIntPtr samples)
+        /// <summary>
+        /// Writes every input channel in one call, from a buffer interleaved by the input channel count.
+        /// </summary>
+        public void WriteInputInterleaved(UIntPtr offset, UIntPtr length, float[] interleavedInput)
         {
             unsafe
             {
@@ -623,11 +885,15 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_MoveOutput(Handle, samples);
+                fixed (float* ptr = interleavedInput)
+                {
+                    functions.WriteInputInterleaved(Handle, offset, length, ptr);
+                }
             }
         }
 
-        public void AnalysisOffset(UIntPtr offset)
+#if NET7_0_OR_GREATER
+        public void WriteInputInterleaved(UIntPtr offset, UIntPtr length, ReadOnlySpan<float> interleavedInput)
         {
             unsafe
             {
@@ -636,11 +902,28 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_AnalysisOffset(Handle, offset);
+                fixed (float* ptr = interleavedInput)
+                {
+                    functions.WriteInputInterleaved(Handle, offset, length, ptr);
+                }
             }
         }
+#endif
 
-        public void SynthesisOffset(UIntPtr offset)
+        public unsafe void WriteInputInterleaved(UIntPtr offset, UIntPtr length, float* interleavedInput)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.WriteInputInterleaved(Handle, offset, length, interleavedInput);
+        }
+
+        /// <summary>
+        /// Writes every input channel in one call, one array per channel.
+        /// </summary>
+        public void WriteInputPlanar(UIntPtr offset, UIntPtr length, float[][] inputs)
         {
             unsafe
             {
@@ -649,31 +932,715 @@ namespace Signalsmith
                     throw new ObjectDisposedException("STFT");
                 }
 
-                Native.STFT_SynthesisOffset(Handle, offset);
+                GCHandle* handles = stackalloc GCHandle[inputs.Length];
+                float** pointers = stackalloc float*[inputs.Length];
+                Stretch.PinChannels(inputs, handles, pointers);
+                try
+                {
+                    functions.WriteInputPlanar(Handle, offset, length, pointers);
+                }
+                finally
+                {
+                    Stretch.UnpinChannels(handles, inputs.Length);
+                }
             }
         }
-    }
 
-    internal static partial class Native
-    {
-#if NET7_0_OR_GREATER
-        [LibraryImport(DllName, EntryPoint = "STFT_Create")]
-        public static unsafe partial void* STFT_Create([MarshalAs(UnmanagedType.I1)] bool splitComputation);
+        public unsafe void WriteInputPlanar(UIntPtr offset, UIntPtr length, float** inputs)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
 
-        [LibraryImport(DllName, EntryPoint = "STFT_Delete")]
-        public static unsafe partial void STFT_Delete(void* stft);
+            functions.WriteInputPlanar(Handle, offset, length, inputs);
+        }
 
-        [LibraryImport(DllName, EntryPoint = "STFT_Configure")]
-        public static unsafe partial void STFT_Configure(void* stft, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry);
+        /// <summary>
+        /// Reads every output channel in one call, into a buffer interleaved by the output channel count.
+        /// </summary>
+        public void ReadOutputInterleaved(UIntPtr offset, UIntPtr length, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
 
-        [LibraryImport(DllName, EntryPoint = "STFT_BlockSamples")]
-        public static unsafe partial UIntPtr STFT_BlockSamples(void* stft);
+                fixed (float* ptr = interleavedOutput)
+                {
+                    functions.ReadOutputInterleaved(Handle, offset, length, ptr);
+                }
+            }
+        }
 
-        [LibraryImport(DllName, EntryPoint = "STFT_FFTSamples")]
-        public static unsafe partial UIntPtr STFT_FFTSamples(void* stft);
+#if NET7_0_OR_GREATER
+        public void ReadOutputInterleaved(UIntPtr offset, UIntPtr length, Span<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
 
-        [LibraryImport(DllName, EntryPoint = "STFT_Bands")]
-        public static unsafe partial UIntPtr STFT_Bands(void* stft);
+                fixed (float* ptr = interleavedOutput)
+                {
+                    functions.ReadOutputInterleaved(Handle, offset, length, ptr);
+                }
+            }
+        }
+#endif
+
+        public unsafe void ReadOutputInterleaved(UIntPtr offset, UIntPtr length, float* interleavedOutput)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.ReadOutputInterleaved(Handle, offset, length, interleavedOutput);
+        }
+
+        public void ReadOutputPlanar(UIntPtr offset, UIntPtr length, float[][] outputs)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                GCHandle* handles = stackalloc GCHandle[outputs.Length];
+                float** pointers = stackalloc float*[outputs.Length];
+                Stretch.PinChannels(outputs, handles, pointers);
+                try
+                {
+                    functions.ReadOutputPlanar(Handle, offset, length, pointers);
+                }
+                finally
+                {
+                    Stretch.UnpinChannels(handles, outputs.Length);
+                }
+            }
+        }
+
+        public unsafe void ReadOutputPlanar(UIntPtr offset, UIntPtr length, float** outputs)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.ReadOutputPlanar(Handle, offset, length, outputs);
+        }
+
+        public void AddOutputInterleaved(UIntPtr offset, UIntPtr length, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* ptr = interleavedOutput)
+                {
+                    functions.AddOutputInterleaved(Handle, offset, length, ptr);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void AddOutputInterleaved(UIntPtr offset, UIntPtr length, ReadOnlySpan<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* ptr = interleavedOutput)
+                {
+                    functions.AddOutputInterleaved(Handle, offset, length, ptr);
+                }
+            }
+        }
+#endif
+
+        public unsafe void AddOutputInterleaved(UIntPtr offset, UIntPtr length, float* interleavedOutput)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.AddOutputInterleaved(Handle, offset, length, interleavedOutput);
+        }
+
+        public void AddOutputPlanar(UIntPtr offset, UIntPtr length, float[][] outputs)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                GCHandle* handles = stackalloc GCHandle[outputs.Length];
+                float** pointers = stackalloc float*[outputs.Length];
+                Stretch.PinChannels(outputs, handles, pointers);
+                try
+                {
+                    functions.AddOutputPlanar(Handle, offset, length, pointers);
+                }
+                finally
+                {
+                    Stretch.UnpinChannels(handles, outputs.Length);
+                }
+            }
+        }
+
+        public unsafe void AddOutputPlanar(UIntPtr offset, UIntPtr length, float** outputs)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.AddOutputPlanar(Handle, offset, length, outputs);
+        }
+
+        public void ReplaceOutputInterleaved(UIntPtr offset, UIntPtr length, float[] interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* ptr = interleavedOutput)
+                {
+                    functions.ReplaceOutputInterleaved(Handle, offset, length, ptr);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void ReplaceOutputInterleaved(UIntPtr offset, UIntPtr length, ReadOnlySpan<float> interleavedOutput)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                fixed (float* ptr = interleavedOutput)
+                {
+                    functions.ReplaceOutputInterleaved(Handle, offset, length, ptr);
+                }
+            }
+        }
+#endif
+
+        public unsafe void ReplaceOutputInterleaved(UIntPtr offset, UIntPtr length, float* interleavedOutput)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.ReplaceOutputInterleaved(Handle, offset, length, interleavedOutput);
+        }
+
+        public void ReplaceOutputPlanar(UIntPtr offset, UIntPtr length, float[][] outputs)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                GCHandle* handles = stackalloc GCHandle[outputs.Length];
+                float** pointers = stackalloc float*[outputs.Length];
+                Stretch.PinChannels(outputs, handles, pointers);
+                try
+                {
+                    functions.ReplaceOutputPlanar(Handle, offset, length, pointers);
+                }
+                finally
+                {
+                    Stretch.UnpinChannels(handles, outputs.Length);
+                }
+            }
+        }
+
+        public unsafe void ReplaceOutputPlanar(UIntPtr offset, UIntPtr length, float** outputs)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFT");
+            }
+
+            functions.ReplaceOutputPlanar(Handle, offset, length, outputs);
+        }
+
+        public void MoveOutput(UIntPtr samples)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                functions.MoveOutput(Handle, samples);
+            }
+        }
+
+        public void AnalysisOffset(UIntPtr offset)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                Native.STFT_AnalysisOffset(Handle, offset);
+            }
+        }
+
+        public void SynthesisOffset(UIntPtr offset)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                Native.STFT_SynthesisOffset(Handle, offset);
+            }
+        }
+    }
+
+#if NET7_0_OR_GREATER
+    /// <summary>
+    /// Table of the STFT_Plain_* or STFT_Split_* exports, so each call goes straight to one native instantiation.
+    /// </summary>
+    internal sealed unsafe class STFTFunctions
+    {
+        public readonly delegate*<void*, UIntPtr, UIntPtr, UIntPtr, float*, void> WriteInput;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, UIntPtr, float*, void> ReadOutput;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, UIntPtr, float*, void> AddOutput;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, UIntPtr, float*, void> ReplaceOutput;
+        public readonly delegate*<void*, UIntPtr, bool, void> MoveInput;
+        public readonly delegate*<void*, UIntPtr, void> MoveOutput;
+        public readonly delegate*<void*, UIntPtr, void> Analyse;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, void> AnalyseStep;
+        public readonly delegate*<void*, void> Synthesise;
+        public readonly delegate*<void*, UIntPtr, void> SynthesiseStep;
+        public readonly delegate*<void*, UIntPtr, float*> SpectrumPtr;
+        public readonly delegate*<void*, UIntPtr, float*, float*, void> ReadSpectrum;
+        public readonly delegate*<void*, UIntPtr, float*, void> ReadSpectrumInterleaved;
+        public readonly delegate*<void*, UIntPtr, float*, float*, void> WriteSpectrum;
+        public readonly delegate*<void*, UIntPtr, float*, void> WriteSpectrumInterleaved;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float*, void> WriteInputInterleaved;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float**, void> WriteInputPlanar;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float*, void> ReadOutputInterleaved;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float**, void> ReadOutputPlanar;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float*, void> AddOutputInterleaved;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float**, void> AddOutputPlanar;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float*, void> ReplaceOutputInterleaved;
+        public readonly delegate*<void*, UIntPtr, UIntPtr, float**, void> ReplaceOutputPlanar;
+        public readonly delegate*<void*, float*, UIntPtr, float*, UIntPtr, delegate* unmanaged<void*, float**, int, int, void>, void*, void> ProcessBlock;
+
+        public static readonly STFTFunctions Plain = new STFTFunctions(false);
+        public static readonly STFTFunctions Split = new STFTFunctions(true);
+
+        private STFTFunctions(bool split)
+        {
+            if (split)
+            {
+                WriteInput = &Native.STFT_Split_WriteInput;
+                ReadOutput = &Native.STFT_Split_ReadOutput;
+                AddOutput = &Native.STFT_Split_AddOutput;
+                ReplaceOutput = &Native.STFT_Split_ReplaceOutput;
+                MoveInput = &Native.STFT_Split_MoveInput;
+                MoveOutput = &Native.STFT_Split_MoveOutput;
+                Analyse = &Native.STFT_Split_Analyse;
+                AnalyseStep = &Native.STFT_Split_AnalyseStep;
+                Synthesise = &Native.STFT_Split_Synthesise;
+                SynthesiseStep = &Native.STFT_Split_SynthesiseStep;
+                SpectrumPtr = &Native.STFT_Split_SpectrumPtr;
+                ReadSpectrum = &Native.STFT_Split_ReadSpectrum;
+                ReadSpectrumInterleaved = &Native.STFT_Split_ReadSpectrumInterleaved;
+                WriteSpectrum = &Native.STFT_Split_WriteSpectrum;
+                WriteSpectrumInterleaved = &Native.STFT_Split_WriteSpectrumInterleaved;
+                WriteInputInterleaved = &Native.STFT_Split_WriteInputInterleaved;
+                WriteInputPlanar = &Native.STFT_Split_WriteInputPlanar;
+                ReadOutputInterleaved = &Native.STFT_Split_ReadOutputInterleaved;
+                ReadOutputPlanar = &Native.STFT_Split_ReadOutputPlanar;
+                AddOutputInterleaved = &Native.STFT_Split_AddOutputInterleaved;
+                AddOutputPlanar = &Native.STFT_Split_AddOutputPlanar;
+                ReplaceOutputInterleaved = &Native.STFT_Split_ReplaceOutputInterleaved;
+                ReplaceOutputPlanar = &Native.STFT_Split_ReplaceOutputPlanar;
+                ProcessBlock = &Native.STFT_Split_ProcessBlock;
+            }
+            else
+            {
+                WriteInput = &Native.STFT_Plain_WriteInput;
+                ReadOutput = &Native.STFT_Plain_ReadOutput;
+                AddOutput = &Native.STFT_Plain_AddOutput;
+                ReplaceOutput = &Native.STFT_Plain_ReplaceOutput;
+                MoveInput = &Native.STFT_Plain_MoveInput;
+                MoveOutput = &Native.STFT_Plain_MoveOutput;
+                Analyse = &Native.STFT_Plain_Analyse;
+                AnalyseStep = &Native.STFT_Plain_AnalyseStep;
+                Synthesise = &Native.STFT_Plain_Synthesise;
+                SynthesiseStep = &Native.STFT_Plain_SynthesiseStep;
+                SpectrumPtr = &Native.STFT_Plain_SpectrumPtr;
+                ReadSpectrum = &Native.STFT_Plain_ReadSpectrum;
+                ReadSpectrumInterleaved = &Native.STFT_Plain_ReadSpectrumInterleaved;
+                WriteSpectrum = &Native.STFT_Plain_WriteSpectrum;
+                WriteSpectrumInterleaved = &Native.STFT_Plain_WriteSpectrumInterleaved;
+                WriteInputInterleaved = &Native.STFT_Plain_WriteInputInterleaved;
+                WriteInputPlanar = &Native.STFT_Plain_WriteInputPlanar;
+                ReadOutputInterleaved = &Native.STFT_Plain_ReadOutputInterleaved;
+                ReadOutputPlanar = &Native.STFT_Plain_ReadOutputPlanar;
+                AddOutputInterleaved = &Native.STFT_Plain_AddOutputInterleaved;
+                AddOutputPlanar = &Native.STFT_Plain_AddOutputPlanar;
+                ReplaceOutputInterleaved = &Native.STFT_Plain_ReplaceOutputInterleaved;
+                ReplaceOutputPlanar = &Native.STFT_Plain_ReplaceOutputPlanar;
+                ProcessBlock = &Native.STFT_Plain_ProcessBlock;
+            }
+        }
+    }
+#else
+    /// <summary>
+    /// Calls the STFT_Plain_* or STFT_Split_* exports, so each call goes straight to one native instantiation.
+    /// </summary>
+    internal sealed unsafe class STFTFunctions
+    {
+        private readonly bool split;
+
+        public static readonly STFTFunctions Plain = new STFTFunctions(false);
+        public static readonly STFTFunctions Split = new STFTFunctions(true);
+
+        private STFTFunctions(bool split)
+        {
+            this.split = split;
+        }
+
+        public void WriteInput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* inputArray)
+        {
+            if (split)
+            {
+                Native.STFT_Split_WriteInput(stft, channel, offset, length, inputArray);
+            }
+            else
+            {
+                Native.STFT_Plain_WriteInput(stft, channel, offset, length, inputArray);
+            }
+        }
+
+        public void ReadOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReadOutput(stft, channel, offset, length, outputArray);
+            }
+            else
+            {
+                Native.STFT_Plain_ReadOutput(stft, channel, offset, length, outputArray);
+            }
+        }
+
+        public void AddOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray)
+        {
+            if (split)
+            {
+                Native.STFT_Split_AddOutput(stft, channel, offset, length, outputArray);
+            }
+            else
+            {
+                Native.STFT_Plain_AddOutput(stft, channel, offset, length, outputArray);
+            }
+        }
+
+        public void ReplaceOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReplaceOutput(stft, channel, offset, length, outputArray);
+            }
+            else
+            {
+                Native.STFT_Plain_ReplaceOutput(stft, channel, offset, length, outputArray);
+            }
+        }
+
+        public void MoveInput(void* stft, UIntPtr samples, bool clearMovedRegion)
+        {
+            if (split)
+            {
+                Native.STFT_Split_MoveInput(stft, samples, clearMovedRegion);
+            }
+            else
+            {
+                Native.STFT_Plain_MoveInput(stft, samples, clearMovedRegion);
+            }
+        }
+
+        public void MoveOutput(void* stft, UIntPtr samples)
+        {
+            if (split)
+            {
+                Native.STFT_Split_MoveOutput(stft, samples);
+            }
+            else
+            {
+                Native.STFT_Plain_MoveOutput(stft, samples);
+            }
+        }
+
+        public void Analyse(void* stft, UIntPtr sampleInPast)
+        {
+            if (split)
+            {
+                Native.STFT_Split_Analyse(stft, sampleInPast);
+            }
+            else
+            {
+                Native.STFT_Plain_Analyse(stft, sampleInPast);
+            }
+        }
+
+        public void AnalyseStep(void* stft, UIntPtr step, UIntPtr sampleInPast)
+        {
+            if (split)
+            {
+                Native.STFT_Split_AnalyseStep(stft, step, sampleInPast);
+            }
+            else
+            {
+                Native.STFT_Plain_AnalyseStep(stft, step, sampleInPast);
+            }
+        }
+
+        public void Synthesise(void* stft)
+        {
+            if (split)
+            {
+                Native.STFT_Split_Synthesise(stft);
+            }
+            else
+            {
+                Native.STFT_Plain_Synthesise(stft);
+            }
+        }
+
+        public void SynthesiseStep(void* stft, UIntPtr step)
+        {
+            if (split)
+            {
+                Native.STFT_Split_SynthesiseStep(stft, step);
+            }
+            else
+            {
+                Native.STFT_Plain_SynthesiseStep(stft, step);
+            }
+        }
+
+        public float* SpectrumPtr(void* stft, UIntPtr channel)
+        {
+            return split ? Native.STFT_Split_SpectrumPtr(stft, channel) : Native.STFT_Plain_SpectrumPtr(stft, channel);
+        }
+
+        public void ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReadSpectrum(stft, channel, outputReal, outputImag);
+            }
+            else
+            {
+                Native.STFT_Plain_ReadSpectrum(stft, channel, outputReal, outputImag);
+            }
+        }
+
+        public void ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReadSpectrumInterleaved(stft, channel, interleavedOutput);
+            }
+            else
+            {
+                Native.STFT_Plain_ReadSpectrumInterleaved(stft, channel, interleavedOutput);
+            }
+        }
+
+        public void WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag)
+        {
+            if (split)
+            {
+                Native.STFT_Split_WriteSpectrum(stft, channel, inputReal, inputImag);
+            }
+            else
+            {
+                Native.STFT_Plain_WriteSpectrum(stft, channel, inputReal, inputImag);
+            }
+        }
+
+        public void WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput)
+        {
+            if (split)
+            {
+                Native.STFT_Split_WriteSpectrumInterleaved(stft, channel, interleavedInput);
+            }
+            else
+            {
+                Native.STFT_Plain_WriteSpectrumInterleaved(stft, channel, interleavedInput);
+            }
+        }
+
+        public void WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput)
+        {
+            if (split)
+            {
+                Native.STFT_Split_WriteInputInterleaved(stft, offset, length, interleavedInput);
+            }
+            else
+            {
+                Native.STFT_Plain_WriteInputInterleaved(stft, offset, length, interleavedInput);
+            }
+        }
+
+        public void WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs)
+        {
+            if (split)
+            {
+                Native.STFT_Split_WriteInputPlanar(stft, offset, length, inputs);
+            }
+            else
+            {
+                Native.STFT_Plain_WriteInputPlanar(stft, offset, length, inputs);
+            }
+        }
+
+        public void ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReadOutputInterleaved(stft, offset, length, interleavedOutput);
+            }
+            else
+            {
+                Native.STFT_Plain_ReadOutputInterleaved(stft, offset, length, interleavedOutput);
+            }
+        }
+
+        public void ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReadOutputPlanar(stft, offset, length, outputs);
+            }
+            else
+            {
+                Native.STFT_Plain_ReadOutputPlanar(stft, offset, length, outputs);
+            }
+        }
+
+        public void AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput)
+        {
+            if (split)
+            {
+                Native.STFT_Split_AddOutputInterleaved(stft, offset, length, interleavedOutput);
+            }
+            else
+            {
+                Native.STFT_Plain_AddOutputInterleaved(stft, offset, length, interleavedOutput);
+            }
+        }
+
+        public void AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs)
+        {
+            if (split)
+            {
+                Native.STFT_Split_AddOutputPlanar(stft, offset, length, outputs);
+            }
+            else
+            {
+                Native.STFT_Plain_AddOutputPlanar(stft, offset, length, outputs);
+            }
+        }
+
+        public void ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReplaceOutputInterleaved(stft, offset, length, interleavedOutput);
+            }
+            else
+            {
+                Native.STFT_Plain_ReplaceOutputInterleaved(stft, offset, length, interleavedOutput);
+            }
+        }
+
+        public void ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ReplaceOutputPlanar(stft, offset, length, outputs);
+            }
+            else
+            {
+                Native.STFT_Plain_ReplaceOutputPlanar(stft, offset, length, outputs);
+            }
+        }
+
+        public void ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, IntPtr callback, void* userData)
+        {
+            if (split)
+            {
+                Native.STFT_Split_ProcessBlock(stft, input, inputLength, output, outputLength, callback, userData);
+            }
+            else
+            {
+                Native.STFT_Plain_ProcessBlock(stft, input, inputLength, output, outputLength, callback, userData);
+            }
+        }
+    }
+#endif
+
+    internal static partial class Native
+    {
+#if NET7_0_OR_GREATER
+        [LibraryImport(DllName, EntryPoint = "STFT_Create")]
+        public static unsafe partial void* STFT_Create([MarshalAs(UnmanagedType.I1)] bool splitComputation);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Delete")]
+        public static unsafe partial void STFT_Delete(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Configure")]
+        public static unsafe partial void STFT_Configure(void* stft, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_BlockSamples")]
+        public static unsafe partial UIntPtr STFT_BlockSamples(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_FFTSamples")]
+        public static unsafe partial UIntPtr STFT_FFTSamples(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Bands")]
+        public static unsafe partial UIntPtr STFT_Bands(void* stft);
 
         [LibraryImport(DllName, EntryPoint = "STFT_Reset")]
         public static unsafe partial void STFT_Reset(void* stft);
@@ -699,6 +1666,21 @@ namespace Signalsmith
         [LibraryImport(DllName, EntryPoint = "STFT_Spectrum")]
         public static unsafe partial float* STFT_Spectrum(void* stft, UIntPtr channel);
 
+        [LibraryImport(DllName, EntryPoint = "STFT_SpectrumPtr")]
+        public static unsafe partial float* STFT_SpectrumPtr(void* stft, UIntPtr channel);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ReadSpectrum")]
+        public static unsafe partial void STFT_ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ReadSpectrumInterleaved")]
+        public static unsafe partial void STFT_ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_WriteSpectrum")]
+        public static unsafe partial void STFT_WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_WriteSpectrumInterleaved")]
+        public static unsafe partial void STFT_WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput);
+
         [LibraryImport(DllName, EntryPoint = "STFT_AnalysisWindow")]
         public static unsafe partial float* STFT_AnalysisWindow(void* stft);
 
@@ -755,6 +1737,185 @@ namespace Signalsmith
 
         [LibraryImport(DllName, EntryPoint = "STFT_SynthesisOffset")]
         public static unsafe partial void STFT_SynthesisOffset(void* stft, UIntPtr offset);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_WriteInput")]
+        public static unsafe partial void STFT_Plain_WriteInput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* inputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReadOutput")]
+        public static unsafe partial void STFT_Plain_ReadOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_AddOutput")]
+        public static unsafe partial void STFT_Plain_AddOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReplaceOutput")]
+        public static unsafe partial void STFT_Plain_ReplaceOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_MoveInput")]
+        public static unsafe partial void STFT_Plain_MoveInput(void* stft, UIntPtr samples, [MarshalAs(UnmanagedType.I1)] bool clearMovedRegion);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_MoveOutput")]
+        public static unsafe partial void STFT_Plain_MoveOutput(void* stft, UIntPtr samples);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_Analyse")]
+        public static unsafe partial void STFT_Plain_Analyse(void* stft, UIntPtr sampleInPast);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_AnalyseStep")]
+        public static unsafe partial void STFT_Plain_AnalyseStep(void* stft, UIntPtr step, UIntPtr sampleInPast);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_Synthesise")]
+        public static unsafe partial void STFT_Plain_Synthesise(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_SynthesiseStep")]
+        public static unsafe partial void STFT_Plain_SynthesiseStep(void* stft, UIntPtr step);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_SpectrumPtr")]
+        public static unsafe partial float* STFT_Plain_SpectrumPtr(void* stft, UIntPtr channel);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReadSpectrum")]
+        public static unsafe partial void STFT_Plain_ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReadSpectrumInterleaved")]
+        public static unsafe partial void STFT_Plain_ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_WriteSpectrum")]
+        public static unsafe partial void STFT_Plain_WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_WriteSpectrumInterleaved")]
+        public static unsafe partial void STFT_Plain_WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_WriteInput")]
+        public static unsafe partial void STFT_Split_WriteInput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* inputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReadOutput")]
+        public static unsafe partial void STFT_Split_ReadOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_AddOutput")]
+        public static unsafe partial void STFT_Split_AddOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReplaceOutput")]
+        public static unsafe partial void STFT_Split_ReplaceOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_MoveInput")]
+        public static unsafe partial void STFT_Split_MoveInput(void* stft, UIntPtr samples, [MarshalAs(UnmanagedType.I1)] bool clearMovedRegion);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_MoveOutput")]
+        public static unsafe partial void STFT_Split_MoveOutput(void* stft, UIntPtr samples);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_Analyse")]
+        public static unsafe partial void STFT_Split_Analyse(void* stft, UIntPtr sampleInPast);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_AnalyseStep")]
+        public static unsafe partial void STFT_Split_AnalyseStep(void* stft, UIntPtr step, UIntPtr sampleInPast);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_Synthesise")]
+        public static unsafe partial void STFT_Split_Synthesise(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_SynthesiseStep")]
+        public static unsafe partial void STFT_Split_SynthesiseStep(void* stft, UIntPtr step);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_SpectrumPtr")]
+        public static unsafe partial float* STFT_Split_SpectrumPtr(void* stft, UIntPtr channel);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReadSpectrum")]
+        public static unsafe partial void STFT_Split_ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReadSpectrumInterleaved")]
+        public static unsafe partial void STFT_Split_ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_WriteSpectrum")]
+        public static unsafe partial void STFT_Split_WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_WriteSpectrumInterleaved")]
+        public static unsafe partial void STFT_Split_WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_WriteInputInterleaved")]
+        public static unsafe partial void STFT_WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_WriteInputPlanar")]
+        public static unsafe partial void STFT_WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ReadOutputInterleaved")]
+        public static unsafe partial void STFT_ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ReadOutputPlanar")]
+        public static unsafe partial void STFT_ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_AddOutputInterleaved")]
+        public static unsafe partial void STFT_AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_AddOutputPlanar")]
+        public static unsafe partial void STFT_AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ReplaceOutputInterleaved")]
+        public static unsafe partial void STFT_ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ReplaceOutputPlanar")]
+        public static unsafe partial void STFT_ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_WriteInputInterleaved")]
+        public static unsafe partial void STFT_Plain_WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_WriteInputPlanar")]
+        public static unsafe partial void STFT_Plain_WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReadOutputInterleaved")]
+        public static unsafe partial void STFT_Plain_ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReadOutputPlanar")]
+        public static unsafe partial void STFT_Plain_ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_AddOutputInterleaved")]
+        public static unsafe partial void STFT_Plain_AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_AddOutputPlanar")]
+        public static unsafe partial void STFT_Plain_AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReplaceOutputInterleaved")]
+        public static unsafe partial void STFT_Plain_ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ReplaceOutputPlanar")]
+        public static unsafe partial void STFT_Plain_ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_WriteInputInterleaved")]
+        public static unsafe partial void STFT_Split_WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_WriteInputPlanar")]
+        public static unsafe partial void STFT_Split_WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReadOutputInterleaved")]
+        public static unsafe partial void STFT_Split_ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReadOutputPlanar")]
+        public static unsafe partial void STFT_Split_ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_AddOutputInterleaved")]
+        public static unsafe partial void STFT_Split_AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_AddOutputPlanar")]
+        public static unsafe partial void STFT_Split_AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReplaceOutputInterleaved")]
+        public static unsafe partial void STFT_Split_ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ReplaceOutputPlanar")]
+        public static unsafe partial void STFT_Split_ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_ProcessBlock")]
+        public static unsafe partial void STFT_ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, delegate* unmanaged<void*, float**, int, int, void> callback, void* userData);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Plain_ProcessBlock")]
+        public static unsafe partial void STFT_Plain_ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, delegate* unmanaged<void*, float**, int, int, void> callback, void* userData);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_Split_ProcessBlock")]
+        public static unsafe partial void STFT_Split_ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, delegate* unmanaged<void*, float**, int, int, void> callback, void* userData);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_DefaultInterval")]
+        public static unsafe partial UIntPtr STFT_DefaultInterval(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFT_MemoryFootprint")]
+        public static unsafe partial UIntPtr STFT_MemoryFootprint(void* stft);
+        [LibraryImport(DllName, EntryPoint = "STFT_AllocationsSinceConfigure")]
+        public static unsafe partial UIntPtr STFT_AllocationsSinceConfigure(void* stft);
 #else
         [DllImport(DllName, EntryPoint = "STFT_Create")]
         public static extern unsafe void* STFT_Create(bool splitComputation);
@@ -798,6 +1959,21 @@ namespace Signalsmith
         [DllImport(DllName, EntryPoint = "STFT_Spectrum")]
         public static extern unsafe float* STFT_Spectrum(void* stft, UIntPtr channel);
 
+        [DllImport(DllName, EntryPoint = "STFT_SpectrumPtr")]
+        public static extern unsafe float* STFT_SpectrumPtr(void* stft, UIntPtr channel);
+
+        [DllImport(DllName, EntryPoint = "STFT_ReadSpectrum")]
+        public static extern unsafe void STFT_ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag);
+
+        [DllImport(DllName, EntryPoint = "STFT_ReadSpectrumInterleaved")]
+        public static extern unsafe void STFT_ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_WriteSpectrum")]
+        public static extern unsafe void STFT_WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag);
+
+        [DllImport(DllName, EntryPoint = "STFT_WriteSpectrumInterleaved")]
+        public static extern unsafe void STFT_WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput);
+
         [DllImport(DllName, EntryPoint = "STFT_AnalysisWindow")]
         public static extern unsafe float* STFT_AnalysisWindow(void* stft);
 
@@ -854,6 +2030,185 @@ namespace Signalsmith
 
         [DllImport(DllName, EntryPoint = "STFT_SynthesisOffset")]
         public static extern unsafe void STFT_SynthesisOffset(void* stft, UIntPtr offset);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_WriteInput")]
+        public static extern unsafe void STFT_Plain_WriteInput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* inputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReadOutput")]
+        public static extern unsafe void STFT_Plain_ReadOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_AddOutput")]
+        public static extern unsafe void STFT_Plain_AddOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReplaceOutput")]
+        public static extern unsafe void STFT_Plain_ReplaceOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_MoveInput")]
+        public static extern unsafe void STFT_Plain_MoveInput(void* stft, UIntPtr samples, bool clearMovedRegion);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_MoveOutput")]
+        public static extern unsafe void STFT_Plain_MoveOutput(void* stft, UIntPtr samples);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_Analyse")]
+        public static extern unsafe void STFT_Plain_Analyse(void* stft, UIntPtr sampleInPast);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_AnalyseStep")]
+        public static extern unsafe void STFT_Plain_AnalyseStep(void* stft, UIntPtr step, UIntPtr sampleInPast);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_Synthesise")]
+        public static extern unsafe void STFT_Plain_Synthesise(void* stft);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_SynthesiseStep")]
+        public static extern unsafe void STFT_Plain_SynthesiseStep(void* stft, UIntPtr step);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_SpectrumPtr")]
+        public static extern unsafe float* STFT_Plain_SpectrumPtr(void* stft, UIntPtr channel);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReadSpectrum")]
+        public static extern unsafe void STFT_Plain_ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReadSpectrumInterleaved")]
+        public static extern unsafe void STFT_Plain_ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_WriteSpectrum")]
+        public static extern unsafe void STFT_Plain_WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_WriteSpectrumInterleaved")]
+        public static extern unsafe void STFT_Plain_WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_WriteInput")]
+        public static extern unsafe void STFT_Split_WriteInput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* inputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReadOutput")]
+        public static extern unsafe void STFT_Split_ReadOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_AddOutput")]
+        public static extern unsafe void STFT_Split_AddOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReplaceOutput")]
+        public static extern unsafe void STFT_Split_ReplaceOutput(void* stft, UIntPtr channel, UIntPtr offset, UIntPtr length, float* outputArray);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_MoveInput")]
+        public static extern unsafe void STFT_Split_MoveInput(void* stft, UIntPtr samples, bool clearMovedRegion);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_MoveOutput")]
+        public static extern unsafe void STFT_Split_MoveOutput(void* stft, UIntPtr samples);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_Analyse")]
+        public static extern unsafe void STFT_Split_Analyse(void* stft, UIntPtr sampleInPast);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_AnalyseStep")]
+        public static extern unsafe void STFT_Split_AnalyseStep(void* stft, UIntPtr step, UIntPtr sampleInPast);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_Synthesise")]
+        public static extern unsafe void STFT_Split_Synthesise(void* stft);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_SynthesiseStep")]
+        public static extern unsafe void STFT_Split_SynthesiseStep(void* stft, UIntPtr step);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_SpectrumPtr")]
+        public static extern unsafe float* STFT_Split_SpectrumPtr(void* stft, UIntPtr channel);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReadSpectrum")]
+        public static extern unsafe void STFT_Split_ReadSpectrum(void* stft, UIntPtr channel, float* outputReal, float* outputImag);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReadSpectrumInterleaved")]
+        public static extern unsafe void STFT_Split_ReadSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_WriteSpectrum")]
+        public static extern unsafe void STFT_Split_WriteSpectrum(void* stft, UIntPtr channel, float* inputReal, float* inputImag);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_WriteSpectrumInterleaved")]
+        public static extern unsafe void STFT_Split_WriteSpectrumInterleaved(void* stft, UIntPtr channel, float* interleavedInput);
+
+        [DllImport(DllName, EntryPoint = "STFT_WriteInputInterleaved")]
+        public static extern unsafe void STFT_WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput);
+
+        [DllImport(DllName, EntryPoint = "STFT_WriteInputPlanar")]
+        public static extern unsafe void STFT_WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_ReadOutputInterleaved")]
+        public static extern unsafe void STFT_ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_ReadOutputPlanar")]
+        public static extern unsafe void STFT_ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_AddOutputInterleaved")]
+        public static extern unsafe void STFT_AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_AddOutputPlanar")]
+        public static extern unsafe void STFT_AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_ReplaceOutputInterleaved")]
+        public static extern unsafe void STFT_ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_ReplaceOutputPlanar")]
+        public static extern unsafe void STFT_ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_WriteInputInterleaved")]
+        public static extern unsafe void STFT_Plain_WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_WriteInputPlanar")]
+        public static extern unsafe void STFT_Plain_WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReadOutputInterleaved")]
+        public static extern unsafe void STFT_Plain_ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReadOutputPlanar")]
+        public static extern unsafe void STFT_Plain_ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_AddOutputInterleaved")]
+        public static extern unsafe void STFT_Plain_AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_AddOutputPlanar")]
+        public static extern unsafe void STFT_Plain_AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReplaceOutputInterleaved")]
+        public static extern unsafe void STFT_Plain_ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ReplaceOutputPlanar")]
+        public static extern unsafe void STFT_Plain_ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_WriteInputInterleaved")]
+        public static extern unsafe void STFT_Split_WriteInputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedInput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_WriteInputPlanar")]
+        public static extern unsafe void STFT_Split_WriteInputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** inputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReadOutputInterleaved")]
+        public static extern unsafe void STFT_Split_ReadOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReadOutputPlanar")]
+        public static extern unsafe void STFT_Split_ReadOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_AddOutputInterleaved")]
+        public static extern unsafe void STFT_Split_AddOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_AddOutputPlanar")]
+        public static extern unsafe void STFT_Split_AddOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReplaceOutputInterleaved")]
+        public static extern unsafe void STFT_Split_ReplaceOutputInterleaved(void* stft, UIntPtr offset, UIntPtr length, float* interleavedOutput);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ReplaceOutputPlanar")]
+        public static extern unsafe void STFT_Split_ReplaceOutputPlanar(void* stft, UIntPtr offset, UIntPtr length, float** outputs);
+
+        [DllImport(DllName, EntryPoint = "STFT_ProcessBlock")]
+        public static extern unsafe void STFT_ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, IntPtr callback, void* userData);
+
+        [DllImport(DllName, EntryPoint = "STFT_Plain_ProcessBlock")]
+        public static extern unsafe void STFT_Plain_ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, IntPtr callback, void* userData);
+
+        [DllImport(DllName, EntryPoint = "STFT_Split_ProcessBlock")]
+        public static extern unsafe void STFT_Split_ProcessBlock(void* stft, float* input, UIntPtr inputLength, float* output, UIntPtr outputLength, IntPtr callback, void* userData);
+
+        [DllImport(DllName, EntryPoint = "STFT_DefaultInterval")]
+        public static extern unsafe UIntPtr STFT_DefaultInterval(void* stft);
+
+        [DllImport(DllName, EntryPoint = "STFT_MemoryFootprint")]
+        public static extern unsafe UIntPtr STFT_MemoryFootprint(void* stft);
+        [DllImport(DllName, EntryPoint = "STFT_AllocationsSinceConfigure")]
+        public static extern unsafe UIntPtr STFT_AllocationsSinceConfigure(void* stft);
 #endif
     }
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Signalsmith
+{
+    /// <summary>
+    /// Runs an STFT's hop schedule like STFT.ProcessBlock, but spreads each hop's analyse steps, spectral callback and
+    /// synthesise steps evenly across the following interval, so CPU use per audio callback stays flat.
+    /// This adds one interval of latency (see Latency). Most useful with an STFT created with splitComputation.
+    /// </summary>
+    public class STFTScheduler : IDisposable
+    {
+        public unsafe void* Handle;
+
+        // Keeps the STFT alive while the native scheduler refers to it
+        private readonly STFT stft;
+
+        public STFTScheduler(STFT stft)
+        {
+            unsafe
+            {
+                if (stft.Handle == null)
+                {
+                    throw new ObjectDisposedException("STFT");
+                }
+
+                this.stft = stft;
+                Handle = Native.STFTScheduler_Create(stft.Handle);
+
+                if (Handle == null)
+                {
+                    throw new Exception("Failed to create STFTScheduler instance.");
+                }
+            }
+        }
+
+        ~STFTScheduler()
+        {
+            Release();
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        public void Release()
+        {
+            unsafe
+            {
+                if (Handle != null)
+                {
+                    Native.STFTScheduler_Delete(Handle);
+                    Handle = null;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Sets the hop interval (0 uses the STFT's default interval) and the expected callback length, which is only
+        /// used for the report. Call after configuring the STFT, whose extraInputHistory must be at least the interval
+        /// since each hop is analysed up to one interval late.
+        /// </summary>
+        public void Configure(int intervalSamples, int callbackSamples)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFTScheduler");
+                }
+
+                if (!Native.STFTScheduler_Configure(Handle, (UIntPtr)intervalSamples, (UIntPtr)callbackSamples))
+                {
+                    throw new InvalidOperationException("The STFT must be configured with extraInputHistory of at least the scheduler interval.");
+                }
+            }
+        }
+
+        /// <summary>
+        /// Processes length interleaved samples per channel. The callback is as for STFT.ProcessBlock, and may be zero.
+        /// </summary>
+        public void Process(float[] input, float[] output, int length, IntPtr callback, IntPtr userData)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFTScheduler");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+#if NET7_0_OR_GREATER
+                    Native.STFTScheduler_Process(Handle, inputPtr, outputPtr, (UIntPtr)length, (delegate* unmanaged<void*, float**, int, int, void>)callback, (void*)userData);
+#else
+                    Native.STFTScheduler_Process(Handle, inputPtr, outputPtr, (UIntPtr)length, callback, (void*)userData);
+#endif
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public unsafe void Process(ReadOnlySpan<float> input, Span<float> output, int length, delegate* unmanaged<void*, float**, int, int, void> callback, void* userData)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("STFTScheduler");
+            }
+
+            fixed (float* inputPtr = input)
+            fixed (float* outputPtr = output)
+            {
+                Native.STFTScheduler_Process(Handle, inputPtr, outputPtr, (UIntPtr)length, callback, userData);
+            }
+        }
+#endif
+
+        public int Latency()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFTScheduler");
+                }
+
+                return (int)Native.STFTScheduler_Latency(Handle);
+            }
+        }
+
+        /// <summary>
+        /// CPU budget figures for the most recent Process call, plus maxima since Configure.
+        /// </summary>
+        public STFTScheduleReport Report()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("STFTScheduler");
+                }
+
+                STFTScheduleReport report;
+                Native.STFTScheduler_Report(Handle, &report);
+                return report;
+            }
+        }
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct STFTScheduleReport
+    {
+        /// <summary>Analyse steps, plus one for the spectral callback, plus synthesise steps.</summary>
+        public int StepsPerHop;
+        /// <summary>StepsPerHop spread over one callback of the configured length.</summary>
+        public int ExpectedSteps;
+        public int StepsRun;
+        public int MaxStepsRun;
+        public int HopsCompleted;
+        public float Microseconds;
+        public float MaxMicroseconds;
+    }
+
+    internal static partial class Native
+    {
+#if NET7_0_OR_GREATER
+        [LibraryImport(DllName, EntryPoint = "STFTScheduler_Create")]
+        public static unsafe partial void* STFTScheduler_Create(void* stft);
+
+        [LibraryImport(DllName, EntryPoint = "STFTScheduler_Delete")]
+        public static unsafe partial void STFTScheduler_Delete(void* scheduler);
+
+        [LibraryImport(DllName, EntryPoint = "STFTScheduler_Configure")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool STFTScheduler_Configure(void* scheduler, UIntPtr intervalSamples, UIntPtr callbackSamples);
+
+        [LibraryImport(DllName, EntryPoint = "STFTScheduler_Process")]
+        public static unsafe partial void STFTScheduler_Process(void* scheduler, float* input, float* output, UIntPtr length, delegate* unmanaged<void*, float**, int, int, void> callback, void* userData);
+
+        [LibraryImport(DllName, EntryPoint = "STFTScheduler_Latency")]
+        public static unsafe partial UIntPtr STFTScheduler_Latency(void* scheduler);
+
+        [LibraryImport(DllName, EntryPoint = "STFTScheduler_Report")]
+        public static unsafe partial void STFTScheduler_Report(void* scheduler, STFTScheduleReport* report);
+#else
+        [DllImport(DllName, EntryPoint = "STFTScheduler_Create")]
+        public static extern unsafe void* STFTScheduler_Create(void* stft);
+
+        [DllImport(DllName, EntryPoint = "STFTScheduler_Delete")]
+        public static extern unsafe void STFTScheduler_Delete(void* scheduler);
+
+        [DllImport(DllName, EntryPoint = "STFTScheduler_Configure")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern unsafe bool STFTScheduler_Configure(void* scheduler, UIntPtr intervalSamples, UIntPtr callbackSamples);
+
+        [DllImport(DllName, EntryPoint = "STFTScheduler_Process")]
+        public static extern unsafe void STFTScheduler_Process(void* scheduler, float* input, float* output, UIntPtr length, IntPtr callback, void* userData);
+
+        [DllImport(DllName, EntryPoint = "STFTScheduler_Latency")]
+        public static extern unsafe UIntPtr STFTScheduler_Latency(void* scheduler);
+
+        [DllImport(DllName, EntryPoint = "STFTScheduler_Report")]
+        public static extern unsafe void STFTScheduler_Report(void* scheduler, STFTScheduleReport* report);
+#endif
+    }
+}
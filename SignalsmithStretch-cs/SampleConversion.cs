@@ -0,0 +1,173 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Signalsmith
+{
+    /// <summary>
+    /// Interleaved sample formats accepted by the native conversion functions. Mirrors SampleFormat in binding/convert.h.
+    /// </summary>
+    public enum SampleFormat
+    {
+        Float32 = 0,
+        Int16 = 1,
+        /// <summary>Packed little-endian, three bytes per sample.</summary>
+        Int24 = 2,
+        Int32 = 3,
+    }
+
+    /// <summary>
+    /// Native (SIMD where available) interleave/deinterleave and integer-to-float conversion.
+    /// </summary>
+    public static class SampleConversion
+    {
+        /// <summary>
+        /// Which stereo kernels the native library picked for this CPU: 0 scalar, 1 SSE2, 2 AVX2, 3 NEON.
+        /// </summary>
+        public static int KernelLevel()
+        {
+            return Native.Convert_KernelLevel();
+        }
+
+        public static void ToFloat(short[] input, float[] output)
+        {
+            unsafe
+            {
+                fixed (short* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Convert_ToFloat(inputPtr, (int)SampleFormat.Int16, (UIntPtr)Math.Min(input.Length, output.Length), outputPtr);
+                }
+            }
+        }
+
+        public static void ToFloat(int[] input, float[] output)
+        {
+            unsafe
+            {
+                fixed (int* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Convert_ToFloat(inputPtr, (int)SampleFormat.Int32, (UIntPtr)Math.Min(input.Length, output.Length), outputPtr);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Converts packed 24-bit samples (three bytes each) to float.
+        /// </summary>
+        public static void Int24ToFloat(byte[] input, float[] output)
+        {
+            unsafe
+            {
+                fixed (byte* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Convert_ToFloat(inputPtr, (int)SampleFormat.Int24, (UIntPtr)Math.Min(input.Length / 3, output.Length), outputPtr);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Splits interleaved float frames into one array per channel (planar.Length channels, length frames).
+        /// </summary>
+        public static void Deinterleave(float[] interleaved, float[][] planar, int length)
+        {
+            unsafe
+            {
+                fixed (float* interleavedPtr = interleaved)
+                {
+                    Deinterleave(interleavedPtr, SampleFormat.Float32, planar, length);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Splits interleaved 16-bit frames into one float array per channel, converting as it goes.
+        /// </summary>
+        public static void Deinterleave(short[] interleaved, float[][] planar, int length)
+        {
+            unsafe
+            {
+                fixed (short* interleavedPtr = interleaved)
+                {
+                    Deinterleave(interleavedPtr, SampleFormat.Int16, planar, length);
+                }
+            }
+        }
+
+        public static void Interleave(float[][] planar, float[] interleaved, int length)
+        {
+            unsafe
+            {
+                GCHandle* handles = stackalloc GCHandle[planar.Length];
+                float** pointers = stackalloc float*[planar.Length];
+                Stretch.PinChannels(planar, handles, pointers);
+                try
+                {
+                    fixed (float* interleavedPtr = interleaved)
+                    {
+                        Native.Convert_Interleave(pointers, planar.Length, (UIntPtr)length, interleavedPtr);
+                    }
+                }
+                finally
+                {
+                    Stretch.UnpinChannels(handles, planar.Length);
+                }
+            }
+        }
+
+        public static unsafe void Deinterleave(void* interleaved, SampleFormat format, int channels, int length, float** planar)
+        {
+            Native.Convert_Deinterleave(interleaved, (int)format, channels, (UIntPtr)length, planar);
+        }
+
+        public static unsafe void Interleave(float** planar, int channels, int length, float* interleaved)
+        {
+            Native.Convert_Interleave(planar, channels, (UIntPtr)length, interleaved);
+        }
+
+        private static unsafe void Deinterleave(void* interleaved, SampleFormat format, float[][] planar, int length)
+        {
+            GCHandle* handles = stackalloc GCHandle[planar.Length];
+            float** pointers = stackalloc float*[planar.Length];
+            Stretch.PinChannels(planar, handles, pointers);
+            try
+            {
+                Native.Convert_Deinterleave(interleaved, (int)format, planar.Length, (UIntPtr)length, pointers);
+            }
+            finally
+            {
+                Stretch.UnpinChannels(handles, planar.Length);
+            }
+        }
+    }
+
+    internal static partial class Native
+    {
+#if NET7_0_OR_GREATER
+        [LibraryImport(DllName, EntryPoint = "Convert_ToFloat")]
+        public static unsafe partial void Convert_ToFloat(void* input, int format, UIntPtr count, float* output);
+
+        [LibraryImport(DllName, EntryPoint = "Convert_Deinterleave")]
+        public static unsafe partial void Convert_Deinterleave(void* interleaved, int format, int channels, UIntPtr length, float** planar);
+
+        [LibraryImport(DllName, EntryPoint = "Convert_Interleave")]
+        public static unsafe partial void Convert_Interleave(float** planar, int channels, UIntPtr length, float* interleaved);
+
+        [LibraryImport(DllName, EntryPoint = "Convert_KernelLevel")]
+        public static partial int Convert_KernelLevel();
+#else
+        [DllImport(DllName, EntryPoint = "Convert_ToFloat")]
+        public static extern unsafe void Convert_ToFloat(void* input, int format, UIntPtr count, float* output);
+
+        [DllImport(DllName, EntryPoint = "Convert_Deinterleave")]
+        public static extern unsafe void Convert_Deinterleave(void* interleaved, int format, int channels, UIntPtr length, float** planar);
+
+        [DllImport(DllName, EntryPoint = "Convert_Interleave")]
+        public static extern unsafe void Convert_Interleave(float** planar, int channels, UIntPtr length, float* interleaved);
+
+        [DllImport(DllName, EntryPoint = "Convert_KernelLevel")]
+        public static extern int Convert_KernelLevel();
+#endif
+    }
+}
@@ -10,6 +10,9 @@ namespace Signalsmith
     {
         public unsafe void* Handle;
 
+        // Set for instances rented from a StretchInstancePool, which get handed back instead of freed
+        private StretchInstancePool pool;
+
         public Stretch()
         {
             unsafe
@@ -26,6 +29,20 @@ namespace Signalsmith
             }
         }
 
+        internal unsafe Stretch(void* handle, StretchInstancePool pool)
+        {
+            Handle = handle;
+            this.pool = pool;
+        }
+
+        /// <summary>
+        /// Rents a preconfigured instance from the pool, or returns null if none are free. Disposing it returns it.
+        /// </summary>
+        public static Stretch Rent(StretchInstancePool pool)
+        {
+            return pool.Rent();
+        }
+
         ~Stretch()
         {
             Release();
@@ -43,7 +60,15 @@ namespace Signalsmith
             {
                 if (Handle != null)
                 {
-                    Native.Release(Handle);
+                    if (pool != null)
+                    {
+                        pool.Return(Handle);
+                        pool = null;
+                    }
+                    else
+                    {
+                        Native.Release(Handle);
+                    }
                     Handle = null;
                 }
             }
@@ -88,7 +113,12 @@ namespace Signalsmith
             }
         }
 
-        public void Reset()
+        /// <summary>
+        /// Picks block and interval sizes so input plus output latency fits in maxLatencyMs. cpuBudget sets the block overlap:
+        /// 0 like PresetCheaper, 1 like PresetDefault, more above that. Below 1 split computation is also turned on.
+        /// Returns false if even the smallest block does not fit; chosen holds the settings either way.
+        /// </summary>
+        public bool ConfigureForLatency(int channels, float sampleRate, float maxLatencyMs, float cpuBudget, out StretchLatencyConfig chosen)
         {
             unsafe
             {
@@ -97,11 +127,17 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                Native.Reset(Handle);
+                fixed (StretchLatencyConfig* chosenPtr = &chosen)
+                {
+                    return Native.ConfigureForLatency(Handle, channels, sampleRate, maxLatencyMs, cpuBudget, chosenPtr);
+                }
             }
         }
 
-        public int InputLatency()
+        /// <summary>
+        /// Under 20ms round trip for live monitoring, at the cost of frequency resolution in the low end.
+        /// </summary>
+        public void PresetLowLatency(int channels, float sampleRate, bool splitComputation)
         {
             unsafe
             {
@@ -110,11 +146,14 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                return Native.InputLatency(Handle);
+                Native.PresetLowLatency(Handle, channels, sampleRate, splitComputation);
             }
         }
 
-        public int OutputLatency()
+        /// <summary>
+        /// Block, interval and latency of the current configuration, whichever preset or configure call set it.
+        /// </summary>
+        public StretchLatencyConfig GetLatencyConfig()
         {
             unsafe
             {
@@ -123,11 +162,13 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                return Native.OutputLatency(Handle);
+                StretchLatencyConfig config;
+                Native.GetLatencyConfig(Handle, &config);
+                return config;
             }
         }
 
-        public int BlockSamples()
+        public void Reset()
         {
             unsafe
             {
@@ -136,11 +177,11 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                return Native.BlockSamples(Handle);
+                Native.Reset(Handle);
             }
         }
 
-        public int IntervalSamples()
+        public int InputLatency()
         {
             unsafe
             {
@@ -149,11 +190,11 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                return Native.IntervalSamples(Handle);
+                return Native.InputLatency(Handle);
             }
         }
 
-        public bool SplitComputation()
+        public int OutputLatency()
         {
             unsafe
             {
@@ -162,22 +203,24 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                return Native.SplitComputation(Handle);
+                return Native.OutputLatency(Handle);
             }
         }
-        
-#if NET7_0_OR_GREATER
-        public unsafe void SetFreqMap(delegate* unmanaged<float, float> freqMap)
+
+        public int BlockSamples()
         {
-            if (Handle == null)
+            unsafe
             {
-                throw new ObjectDisposedException("Stretch");
-            }
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
 
-            Native.SetFreqMap(Handle, freqMap);
+                return Native.BlockSamples(Handle);
+            }
         }
-#endif
-        public void SetFreqMap(IntPtr freqMap)
+
+        public int IntervalSamples()
         {
             unsafe
             {
@@ -186,11 +229,14 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                Native.SetFreqMap(Handle, freqMap);
+                return Native.IntervalSamples(Handle);
             }
         }
 
-        public void SetTransposeSemitones(float semitones, float tonalityLimit)
+        /// <summary>
+        /// Heap bytes held by the native binding for this instance, excluding shared frequency maps and the stretcher's internal buffers.
+        /// </summary>
+        public long MemoryFootprint()
         {
             unsafe
             {
@@ -198,12 +244,16 @@ namespace Signalsmith
                 {
                     throw new ObjectDisposedException("Stretch");
                 }
-                
-                Native.SetTransposeSemitones(Handle, semitones, tonalityLimit);
+
+                return (long)(ulong)Native.MemoryFootprint(Handle);
             }
         }
 
-        public void SetTransposeFactor(float factor, float tonalityLimit)
+        /// <summary>
+        /// Reads the process counters since creation or the last ResetStats. Returns false (with zeroed stats)
+        /// if the native library was built without SIGNALSMITH_STRETCH_STATS.
+        /// </summary>
+        public bool GetStats(out StretchStats stats)
         {
             unsafe
             {
@@ -212,11 +262,14 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                Native.SetTransposeFactor(Handle, factor, tonalityLimit);
+                fixed (StretchStats* statsPtr = &stats)
+                {
+                    return Native.GetStats(Handle, statsPtr);
+                }
             }
         }
 
-        public void SetFormantFactor(float multiplier, bool compensatePitch)
+        public void ResetStats()
         {
             unsafe
             {
@@ -225,11 +278,14 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                Native.SetFormantFactor(Handle, multiplier, compensatePitch);
+                Native.ResetStats(Handle);
             }
         }
 
-        public void SetFormantSemitones(float semitones, bool compensatePitch)
+        /// <summary>
+        /// Process calls longer than this are counted in StretchStats.OverBudget. 0 turns the check off.
+        /// </summary>
+        public void SetStatsBudget(double microseconds)
         {
             unsafe
             {
@@ -238,11 +294,15 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                Native.SetFormantSemitones(Handle, semitones, compensatePitch);
+                Native.SetStatsBudget(Handle, microseconds);
             }
         }
 
-        public void SetFormantBase(float baseFreq)
+        /// <summary>
+        /// Builds the spare quality tiers used by SetQualityTier and SetCpuBudget. A setup call like the presets: it
+        /// allocates, so make it before processing starts. Later configure and preset calls rebuild the tiers.
+        /// </summary>
+        public void EnableQualityTiers()
         {
             unsafe
             {
@@ -251,12 +311,19 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                Native.SetFormantBase(Handle, baseFreq);
+                Native.EnableQualityTiers(Handle);
             }
         }
 
-#if NET7_0_OR_GREATER
-        public void Seek(Span<float> input, double playbackRate)
+        /// <summary>
+        /// Requests quality tier 0 (as configured), 1 or 2 (about 2/3 and 1/2 of the cost). Safe to call while
+        /// processing, but has no effect until EnableQualityTiers. The next block seeds the incoming tier and the
+        /// following blocks crossfade into it. Lower tiers use a longer interval, so IntervalSamples changes once the
+        /// switch completes. With split computation BlockSamples shrinks too, keeping the total latency the same, and a
+        /// tier that can't keep it isn't available (the lowest available one is used instead). A CPU budget set with
+        /// SetCpuBudget overrides this.
+        /// </summary>
+        public void SetQualityTier(int tier)
         {
             unsafe
             {
@@ -265,14 +332,14 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                {
-                    Native.Seek(Handle, inputPtr, input.Length, playbackRate);
-                }
+                Native.SetQualityTier(Handle, tier);
             }
         }
 
-        public void Seek(Span<float> input, int pcmLength, float playbackRate)
+        /// <summary>
+        /// The quality tier doing the processing.
+        /// </summary>
+        public int GetQualityTier()
         {
             unsafe
             {
@@ -281,14 +348,15 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                {
-                    Native.Seek(Handle, inputPtr, pcmLength, playbackRate);
-                }
+                return Native.GetQualityTier(Handle);
             }
         }
-#endif
-        public void Seek(float[] input, double playbackRate)
+
+        /// <summary>
+        /// Picks the quality tier adaptively so each process call fits in microsecondsPerBlock, stepping down under load
+        /// and back up when there is room. 0 turns it off. Switches only once EnableQualityTiers has built the tiers.
+        /// </summary>
+        public void SetCpuBudget(float microsecondsPerBlock)
         {
             unsafe
             {
@@ -297,25 +365,62 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                {
-                    Native.Seek(Handle, inputPtr, input.Length, playbackRate);
-                }
+                Native.SetCpuBudget(Handle, microsecondsPerBlock);
             }
         }
 
-        public unsafe void Seek(float* input, int pcmLength, double playbackRate)
+        /// <summary>
+        /// Heap bytes of the frequency maps currently shared between Stretch instances.
+        /// </summary>
+        public static long SharedMemoryFootprint()
         {
-            if (Handle == null)
+            return (long)(ulong)Native.SharedMemoryFootprint();
+        }
+
+#if NET7_0_OR_GREATER
+        /// <summary>
+        /// Routes every allocation the native binding makes through alloc/free, e.g. to back instances with a preallocated arena.
+        /// Blocks must be aligned for any type. Set it before creating instances, while no other thread is using the library.
+        /// </summary>
+        public static unsafe void SetAllocator(delegate* unmanaged<void*, UIntPtr, void*> alloc, delegate* unmanaged<void*, void*, void> free, void* userData)
+        {
+            Native.SetAllocator(alloc, free, userData);
+        }
+#endif
+        public static void SetAllocator(IntPtr alloc, IntPtr free, IntPtr userData)
+        {
+            unsafe
             {
-                throw new ObjectDisposedException("Stretch");
+#if NET7_0_OR_GREATER
+                Native.SetAllocator((delegate* unmanaged<void*, UIntPtr, void*>)alloc, (delegate* unmanaged<void*, void*, void>)free, (void*)userData);
+#else
+                Native.SetAllocator(alloc, free, (void*)userData);
+#endif
             }
+        }
 
-            Native.Seek(Handle, input, pcmLength, playbackRate);
+        /// <summary>
+        /// Restores the default native heap for later allocations.
+        /// </summary>
+        public static void ResetAllocator()
+        {
+            SetAllocator(IntPtr.Zero, IntPtr.Zero, IntPtr.Zero);
         }
 
-#if NET7_0_OR_GREATER
-        public void Flush(Span<float> output, double playbackRate)
+        /// <summary>
+        /// Total allocations made by the native binding since it was loaded.
+        /// </summary>
+        public static long AllocationCount()
+        {
+            return (long)(ulong)Native.AllocationCount();
+        }
+
+        /// <summary>
+        /// Allocations made by the native binding for this instance since its last configure or preset call.
+        /// Nonzero after setup means something allocated while processing. Only allocations routed through
+        /// <see cref="SetAllocator"/> are counted; memory the native library allocates internally is not.
+        /// </summary>
+        public long AllocationsSinceConfigure()
         {
             unsafe
             {
@@ -324,14 +429,11 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* outputPtr = output)
-                {
-                    Native.Flush(Handle, outputPtr, output.Length, playbackRate);
-                }
+                return (long)(ulong)Native.AllocationsSinceConfigure(Handle);
             }
         }
 
-        public void Flush(Span<float> output, int pcmOutLength, double playbackRate)
+        public bool SplitComputation()
         {
             unsafe
             {
@@ -340,14 +442,32 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* outputPtr = output)
+                return Native.SplitComputation(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Runs processing on a native background thread. Process then returns the output of earlier blocks,
+        /// adding maxBlockSamples of latency (included in OutputLatency). maxBlockSamples must be at least the
+        /// largest input or output length passed to Process; 0 turns pipelining off.
+        /// While pipelined, every other method that touches the stretcher (setters, Seek, Reset, presets...)
+        /// waits for the background thread to go idle, so call them only from the thread that calls Process.
+        /// Use PostParams with ProcessParams to change parameters from another thread.
+        /// </summary>
+        public void SetPipelined(int maxBlockSamples)
+        {
+            unsafe
+            {
+                if (Handle == null)
                 {
-                    Native.Flush(Handle, outputPtr, pcmOutLength, playbackRate);
+                    throw new ObjectDisposedException("Stretch");
                 }
+
+                Native.SetPipelined(Handle, maxBlockSamples);
             }
         }
-#endif
-        public void Flush(float[] output, int pcmOutLength, double playbackRate)
+
+        public bool Pipelined()
         {
             unsafe
             {
@@ -356,23 +476,48 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* outputPtr = output)
+                return Native.Pipelined(Handle);
+            }
+        }
+
+        public int PipelineUnderruns()
+        {
+            unsafe
+            {
+                if (Handle == null)
                 {
-                    Native.Flush(Handle, outputPtr, pcmOutLength, playbackRate);
+                    throw new ObjectDisposedException("Stretch");
                 }
+
+                return Native.PipelineUnderruns(Handle);
             }
         }
-        public unsafe void Flush(float* output, int pcmOutLength, double playbackRate)
+
+        /// <summary>
+        /// Publishes a parameter snapshot without blocking. Safe to call from one control thread while another thread
+        /// processes; the values are picked up (gliding over SmoothingMs) by the next ProcessParams call.
+        /// </summary>
+        public void PostParams(in StretchParams parameters)
         {
-            if (Handle == null)
+            unsafe
             {
-                throw new ObjectDisposedException("Stretch");
-            }
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
 
-            Native.Flush(Handle, output, pcmOutLength, playbackRate);
+                fixed (StretchParams* paramsPtr = &parameters)
+                {
+                    Native.PostParams(Handle, paramsPtr);
+                }
+            }
         }
 
-        public int SeekLength()
+        /// <summary>
+        /// Input length for the next block of outputLength samples, following the posted Rate with the same smoothing.
+        /// Call once per block on the processing thread, and pass the result to ProcessParams.
+        /// </summary>
+        public int ParamsInputSamples(int outputLength)
         {
             unsafe
             {
@@ -381,12 +526,14 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                return Native.SeekLength(Handle);
+                return Native.ParamsInputSamples(Handle, outputLength);
             }
         }
 
-#if NET7_0_OR_GREATER
-        public void OutputSeek(Span<float> input, int pcmLength)
+        /// <summary>
+        /// Process, but first applies the most recent PostParams snapshot at the block boundary.
+        /// </summary>
+        public void ProcessParams(float[] input, int inPcmLength, float[] output, int outPcmLength)
         {
             unsafe
             {
@@ -396,13 +543,15 @@ namespace Signalsmith
                 }
 
                 fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
                 {
-                    Native.OutputSeek(Handle, inputPtr, int pcmLength);
+                    Native.ProcessParams(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
                 }
             }
         }
-#endif
-        public void OutputSeek(float[] input, int inputLength)
+
+#if NET7_0_OR_GREATER
+        public void ProcessParams(ReadOnlySpan<float> input, int inPcmLength, Span<float> output, int outPcmLength)
         {
             unsafe
             {
@@ -412,32 +561,42 @@ namespace Signalsmith
                 }
 
                 fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
                 {
-                    Native.OutputSeek(Handle, inputPtr, inputLength);
+                    Native.ProcessParams(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
                 }
             }
         }
+#endif
 
-        public unsafe void OutputSeek(float* input, int inputLength)
+        public unsafe void ProcessParamsPlanar(float** input, int inPcmLength, float** output, int outPcmLength)
         {
             if (Handle == null)
             {
                 throw new ObjectDisposedException("Stretch");
             }
 
-            Native.OutputSeek(Handle, input, inputLength);
+            Native.ProcessParamsPlanar(Handle, input, inPcmLength, output, outPcmLength);
         }
 
-        public int OutputSeekLength(float playbackRate)
+#if NET7_0_OR_GREATER
+        /// <summary>
+        /// Starts pull-based streaming. Each Render call asks read(userData, buffer, frames) for exactly the interleaved
+        /// input it needs; returning fewer frames ends the input, and silence is fed from then on.
+        /// Call Reset first when starting an unrelated stream.
+        /// </summary>
+        public unsafe void RenderStart(delegate* unmanaged<void*, float*, int, int> read, void* userData)
         {
-            unsafe
+            if (Handle == null)
             {
-                return Native.OutputSeekLength(Handle, playbackRate);
+                throw new ObjectDisposedException("Stretch");
             }
+
+            Native.RenderStart(Handle, read, userData);
         }
+#endif
 
-#if NET7_0_OR_GREATER
-        public void Process(Span<float> input, Span<float> output)
+        public void RenderStart(IntPtr read, IntPtr userData)
         {
             unsafe
             {
@@ -446,15 +605,19 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                fixed (float* outputPtr = output)
-                {
-                    Native.Process(Handle, inputPtr, input.Length, outputPtr, output.Length);
-                }
+#if NET7_0_OR_GREATER
+                Native.RenderStart(Handle, (delegate* unmanaged<void*, float*, int, int>)read, (void*)userData);
+#else
+                Native.RenderStart(Handle, read, (void*)userData);
+#endif
             }
         }
 
-        public void Process(Span<float> input, int inPcmLength, Span<float> output, int outPcmLength)
+        /// <summary>
+        /// Input frames per output frame from the next Render call. Safe to call from a control thread while another
+        /// thread renders. Replaces any time map.
+        /// </summary>
+        public void SetRenderRate(double rate)
         {
             unsafe
             {
@@ -463,15 +626,16 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                fixed (float* outputPtr = output)
-                {
-                    Native.Process(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
-                }
+                Native.SetRenderRate(Handle, rate);
             }
         }
-#endif 
-        public void Process(float[] input, float[] output)
+
+        /// <summary>
+        /// Replaces the time map with breakpoints from output frame to input frame, both counted from RenderStart.
+        /// The rate between breakpoints is the slope of each segment, and rateAfter past the last one.
+        /// Call from the rendering thread.
+        /// </summary>
+        public void SetRenderTimeMap(double[] outputFrames, double[] inputFrames, double rateAfter)
         {
             unsafe
             {
@@ -480,15 +644,16 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                fixed (float* outputPtr = output)
+                fixed (double* outputPtr = outputFrames)
+                fixed (double* inputPtr = inputFrames)
                 {
-                    Native.Process(Handle, inputPtr, input.Length, outputPtr, output.Length);
+                    Native.SetRenderTimeMap(Handle, outputPtr, inputPtr, Math.Min(outputFrames.Length, inputFrames.Length), rateAfter);
                 }
             }
         }
 
-        public void Process(float[] input, int inPcmLength, float[] output, int outPcmLength)
+#if NET7_0_OR_GREATER
+        public void SetRenderTimeMap(ReadOnlySpan<double> outputFrames, ReadOnlySpan<double> inputFrames, double rateAfter)
         {
             unsafe
             {
@@ -497,25 +662,37 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
-                fixed (float* outputPtr = output)
+                fixed (double* outputPtr = outputFrames)
+                fixed (double* inputPtr = inputFrames)
                 {
-                    Native.Process(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
+                    Native.SetRenderTimeMap(Handle, outputPtr, inputPtr, Math.Min(outputFrames.Length, inputFrames.Length), rateAfter);
                 }
             }
         }
+#endif
 
-        public unsafe void Process(float* input, int inPcmLength, float* output, int outPcmLength)
+        /// <summary>
+        /// Renders frames interleaved output frames, pulling input through the RenderStart callback.
+        /// Returns the number of input frames pulled.
+        /// </summary>
+        public int Render(float[] output, int frames)
         {
-            if (Handle == null)
+            unsafe
             {
-                throw new ObjectDisposedException("Stretch");
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* outputPtr = output)
+                {
+                    return Native.Render(Handle, outputPtr, frames);
+                }
             }
-            
-            Native.Process(Handle, input, inPcmLength, output, outPcmLength);
         }
 
-        public bool Exact(float[] input, int inPcmLength, float[] output, int outPcmLength)
+#if NET7_0_OR_GREATER
+        public int Render(Span<float> output, int frames)
         {
             unsafe
             {
@@ -524,50 +701,1094 @@ namespace Signalsmith
                     throw new ObjectDisposedException("Stretch");
                 }
 
-                fixed (float* inputPtr = input)
                 fixed (float* outputPtr = output)
                 {
-                    return Native.Exact(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
+                    return Native.Render(Handle, outputPtr, frames);
                 }
             }
         }
+#endif
 
-        public unsafe bool Exact(float* input, int inPcmLength, float* output, int outPcmLength)
+        /// <summary>
+        /// Exact input position, in frames since RenderStart, reached by the output rendered so far.
+        /// </summary>
+        public double RenderInputPosition()
         {
-            if (Handle == null)
+            unsafe
             {
-                throw new ObjectDisposedException("Stretch");
-            }
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
 
-            return Native.Exact(Handle, input, inPcmLength, output, outPcmLength);
+                return Native.RenderInputPosition(Handle);
+            }
         }
-
+        
 #if NET7_0_OR_GREATER
-        public unsafe bool Exact(Span<float> input, int inPcmLength, Span<float> output, int outPcmLength)
+        public unsafe void SetFreqMap(delegate* unmanaged<float, float> freqMap)
         {
             if (Handle == null)
             {
                 throw new ObjectDisposedException("Stretch");
             }
 
-            fixed (float* inputPtr = input)
-            fixed (float* outputPtr = output)
-            {
-                return Native.Exact(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
-            }
+            Native.SetFreqMap(Handle, freqMap);
         }
 #endif
-    }
-
-    internal static partial class Native
-    {
-        public const string DllName = "SignalsmithStretch";
+        public void SetFreqMap(IntPtr freqMap)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
 
 #if NET7_0_OR_GREATER
-        [LibraryImport(DllName, EntryPoint = "Stretch_Create")]
-        public static unsafe partial void* Create();
-        [LibraryImport(DllName, EntryPoint = "Stretch_CreateSeed")]
-        public static unsafe partial void* CreateSeed(long seed);
+                Native.SetFreqMap(Handle, (delegate* unmanaged<float, float>)freqMap);
+#else
+                Native.SetFreqMap(Handle, freqMap);
+#endif
+            }
+        }
+
+        /// <summary>
+        /// Sets a frequency map through (input Hz, output Hz) points, sorted by input frequency.
+        /// The map is precomputed natively, so no managed callback runs during processing.
+        /// Needs at least two points, with positive, strictly increasing input frequencies and non-negative outputs;
+        /// otherwise this throws ArgumentException and the current map stays in place.
+        /// </summary>
+        public void SetFreqMapTable(float[] inputFreqs, float[] outputFreqs, FreqMapInterpolation interpolation = FreqMapInterpolation.Linear)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = inputFreqs)
+                fixed (float* outputPtr = outputFreqs)
+                {
+                    if (!Native.SetFreqMapTable(Handle, inputPtr, outputPtr, Math.Min(inputFreqs.Length, outputFreqs.Length), (int)interpolation))
+                    {
+                        throw new ArgumentException("Frequency map needs at least two points, with positive, strictly increasing inputs and non-negative outputs.", nameof(inputFreqs));
+                    }
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void SetFreqMapTable(ReadOnlySpan<float> inputFreqs, ReadOnlySpan<float> outputFreqs, FreqMapInterpolation interpolation = FreqMapInterpolation.Linear)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = inputFreqs)
+                fixed (float* outputPtr = outputFreqs)
+                {
+                    if (!Native.SetFreqMapTable(Handle, inputPtr, outputPtr, Math.Min(inputFreqs.Length, outputFreqs.Length), (int)interpolation))
+                    {
+                        throw new ArgumentException("Frequency map needs at least two points, with positive, strictly increasing inputs and non-negative outputs.", nameof(inputFreqs));
+                    }
+                }
+            }
+        }
+#endif
+
+        /// <summary>
+        /// Snap-to-scale map: pitches are shifted by transposeSemitones, then pulled towards the nearest scale degree.
+        /// Degrees are semitones above rootHz (e.g. 0, 2, 4, 5, 7, 9, 11 for a major scale), and strength runs from 0 (no snapping) to 1.
+        /// </summary>
+        public void SetFreqMapScale(float rootHz, float[] degrees, float transposeSemitones = 0, float strength = 1)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* degreesPtr = degrees)
+                {
+                    Native.SetFreqMapScale(Handle, rootHz, degreesPtr, degrees.Length, transposeSemitones, strength);
+                }
+            }
+        }
+
+        public void SetTransposeSemitones(float semitones, float tonalityLimit)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+                
+                Native.SetTransposeSemitones(Handle, semitones, tonalityLimit);
+            }
+        }
+
+        public void SetTransposeFactor(float factor, float tonalityLimit)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                Native.SetTransposeFactor(Handle, factor, tonalityLimit);
+            }
+        }
+
+        public void SetFormantFactor(float multiplier, bool compensatePitch)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                Native.SetFormantFactor(Handle, multiplier, compensatePitch);
+            }
+        }
+
+        public void SetFormantSemitones(float semitones, bool compensatePitch)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                Native.SetFormantSemitones(Handle, semitones, compensatePitch);
+            }
+        }
+
+        public void SetFormantBase(float baseFreq)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                Native.SetFormantBase(Handle, baseFreq);
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void Seek(Span<float> input, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                {
+                    Native.Seek(Handle, inputPtr, input.Length, playbackRate);
+                }
+            }
+        }
+
+        public void Seek(Span<float> input, int pcmLength, float playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                {
+                    Native.Seek(Handle, inputPtr, pcmLength, playbackRate);
+                }
+            }
+        }
+#endif
+        public void Seek(float[] input, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                {
+                    Native.Seek(Handle, inputPtr, input.Length, playbackRate);
+                }
+            }
+        }
+
+        public unsafe void Seek(float* input, int pcmLength, double playbackRate)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.Seek(Handle, input, pcmLength, playbackRate);
+        }
+
+#if NET7_0_OR_GREATER
+        public void Flush(Span<float> output, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* outputPtr = output)
+                {
+                    Native.Flush(Handle, outputPtr, output.Length, playbackRate);
+                }
+            }
+        }
+
+        public void Flush(Span<float> output, int pcmOutLength, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* outputPtr = output)
+                {
+                    Native.Flush(Handle, outputPtr, pcmOutLength, playbackRate);
+                }
+            }
+        }
+#endif
+        public void Flush(float[] output, int pcmOutLength, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* outputPtr = output)
+                {
+                    Native.Flush(Handle, outputPtr, pcmOutLength, playbackRate);
+                }
+            }
+        }
+        public unsafe void Flush(float* output, int pcmOutLength, double playbackRate)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.Flush(Handle, output, pcmOutLength, playbackRate);
+        }
+
+        public int SeekLength()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                return Native.SeekLength(Handle);
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void OutputSeek(Span<float> input, int pcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                {
+                    Native.OutputSeek(Handle, inputPtr, pcmLength);
+                }
+            }
+        }
+#endif
+        public void OutputSeek(float[] input, int inputLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                {
+                    Native.OutputSeek(Handle, inputPtr, inputLength);
+                }
+            }
+        }
+
+        public unsafe void OutputSeek(float* input, int inputLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.OutputSeek(Handle, input, inputLength);
+        }
+
+        public int OutputSeekLength(float playbackRate)
+        {
+            unsafe
+            {
+                return Native.OutputSeekLength(Handle, playbackRate);
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void Process(Span<float> input, Span<float> output)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Process(Handle, inputPtr, input.Length, outputPtr, output.Length);
+                }
+            }
+        }
+
+        public void Process(Span<float> input, int inPcmLength, Span<float> output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Process(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+#endif 
+        public void Process(float[] input, float[] output)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Process(Handle, inputPtr, input.Length, outputPtr, output.Length);
+                }
+            }
+        }
+
+        public void Process(float[] input, int inPcmLength, float[] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.Process(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+        // Interleaved integer input (e.g. straight from a decoder), converted to float natively while deinterleaving.
+        // Output is interleaved float, as for Process.
+
+        public void Process(short[] input, int inPcmLength, float[] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (short* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.ProcessFormat(Handle, inputPtr, (int)SampleFormat.Int16, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+        public void Process(int[] input, int inPcmLength, float[] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (int* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.ProcessFormat(Handle, inputPtr, (int)SampleFormat.Int32, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Process with packed little-endian 24-bit input, three bytes per sample.
+        /// </summary>
+        public void ProcessInt24(byte[] input, int inPcmLength, float[] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (byte* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.ProcessFormat(Handle, inputPtr, (int)SampleFormat.Int24, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        public void Process(ReadOnlySpan<short> input, int inPcmLength, Span<float> output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (short* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.ProcessFormat(Handle, inputPtr, (int)SampleFormat.Int16, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+        public void Process(ReadOnlySpan<int> input, int inPcmLength, Span<float> output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (int* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.ProcessFormat(Handle, inputPtr, (int)SampleFormat.Int32, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+        public void ProcessInt24(ReadOnlySpan<byte> input, int inPcmLength, Span<float> output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (byte* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.ProcessFormat(Handle, inputPtr, (int)SampleFormat.Int24, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+#endif
+
+        public unsafe void Process(float* input, int inPcmLength, float* output, int outPcmLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+            
+            Native.Process(Handle, input, inPcmLength, output, outPcmLength);
+        }
+
+        public bool Exact(float[] input, int inPcmLength, float[] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    return Native.Exact(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
+                }
+            }
+        }
+
+        public unsafe bool Exact(float* input, int inPcmLength, float* output, int outPcmLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            return Native.Exact(Handle, input, inPcmLength, output, outPcmLength);
+        }
+
+#if NET7_0_OR_GREATER
+        public unsafe bool Exact(Span<float> input, int inPcmLength, Span<float> output, int outPcmLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            fixed (float* inputPtr = input)
+            fixed (float* outputPtr = output)
+            {
+                return Native.Exact(Handle, inputPtr, inPcmLength, outputPtr, outPcmLength);
+            }
+        }
+#endif
+
+        // Planar (non-interleaved) overloads: one buffer per channel, handed to the native side without
+        // any interleave/de-interleave copy. The outer array length must match the configured channel count.
+
+        public void SeekPlanar(float[][] input, int pcmLength, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                GCHandle* inputHandles = stackalloc GCHandle[input.Length];
+                float** inputPtrs = stackalloc float*[input.Length];
+                PinChannels(input, inputHandles, inputPtrs);
+                try
+                {
+                    Native.SeekPlanar(Handle, inputPtrs, pcmLength, playbackRate);
+                }
+                finally
+                {
+                    UnpinChannels(inputHandles, input.Length);
+                }
+            }
+        }
+
+        public unsafe void SeekPlanar(float** input, int pcmLength, double playbackRate)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.SeekPlanar(Handle, input, pcmLength, playbackRate);
+        }
+
+        public void FlushPlanar(float[][] output, int pcmOutLength, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                GCHandle* outputHandles = stackalloc GCHandle[output.Length];
+                float** outputPtrs = stackalloc float*[output.Length];
+                PinChannels(output, outputHandles, outputPtrs);
+                try
+                {
+                    Native.FlushPlanar(Handle, outputPtrs, pcmOutLength, playbackRate);
+                }
+                finally
+                {
+                    UnpinChannels(outputHandles, output.Length);
+                }
+            }
+        }
+
+        public unsafe void FlushPlanar(float** output, int pcmOutLength, double playbackRate)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.FlushPlanar(Handle, output, pcmOutLength, playbackRate);
+        }
+
+        public void OutputSeekPlanar(float[][] input, int inputLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                GCHandle* inputHandles = stackalloc GCHandle[input.Length];
+                float** inputPtrs = stackalloc float*[input.Length];
+                PinChannels(input, inputHandles, inputPtrs);
+                try
+                {
+                    Native.OutputSeekPlanar(Handle, inputPtrs, inputLength);
+                }
+                finally
+                {
+                    UnpinChannels(inputHandles, input.Length);
+                }
+            }
+        }
+
+        public unsafe void OutputSeekPlanar(float** input, int inputLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.OutputSeekPlanar(Handle, input, inputLength);
+        }
+
+        public void ProcessPlanar(float[][] input, int inPcmLength, float[][] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                GCHandle* inputHandles = stackalloc GCHandle[input.Length];
+                GCHandle* outputHandles = stackalloc GCHandle[output.Length];
+                float** inputPtrs = stackalloc float*[input.Length];
+                float** outputPtrs = stackalloc float*[output.Length];
+                PinChannels(input, inputHandles, inputPtrs);
+                PinChannels(output, outputHandles, outputPtrs);
+                try
+                {
+                    Native.ProcessPlanar(Handle, inputPtrs, inPcmLength, outputPtrs, outPcmLength);
+                }
+                finally
+                {
+                    UnpinChannels(inputHandles, input.Length);
+                    UnpinChannels(outputHandles, output.Length);
+                }
+            }
+        }
+
+        public unsafe void ProcessPlanar(float** input, int inPcmLength, float** output, int outPcmLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            Native.ProcessPlanar(Handle, input, inPcmLength, output, outPcmLength);
+        }
+
+        public bool ExactPlanar(float[][] input, int inPcmLength, float[][] output, int outPcmLength)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                GCHandle* inputHandles = stackalloc GCHandle[input.Length];
+                GCHandle* outputHandles = stackalloc GCHandle[output.Length];
+                float** inputPtrs = stackalloc float*[input.Length];
+                float** outputPtrs = stackalloc float*[output.Length];
+                PinChannels(input, inputHandles, inputPtrs);
+                PinChannels(output, outputHandles, outputPtrs);
+                try
+                {
+                    return Native.ExactPlanar(Handle, inputPtrs, inPcmLength, outputPtrs, outPcmLength);
+                }
+                finally
+                {
+                    UnpinChannels(inputHandles, input.Length);
+                    UnpinChannels(outputHandles, output.Length);
+                }
+            }
+        }
+
+        public unsafe bool ExactPlanar(float** input, int inPcmLength, float** output, int outPcmLength)
+        {
+            if (Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            return Native.ExactPlanar(Handle, input, inPcmLength, output, outPcmLength);
+        }
+
+        /// <summary>
+        /// Number of output frames Stretch.RenderOffline produces for the given input length and playback rate,
+        /// or 0 if inputFrames is not positive or playbackRate is not a positive finite number.
+        /// </summary>
+        public static long RenderOfflineLength(long inputFrames, double playbackRate)
+        {
+            return Native.RenderOfflineLength(inputFrames, playbackRate);
+        }
+
+        private static void CheckRenderOffline(int channels, float sampleRate, double playbackRate)
+        {
+            if (channels <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(channels));
+            }
+
+            if (!(sampleRate > 0) || float.IsInfinity(sampleRate))
+            {
+                throw new ArgumentOutOfRangeException(nameof(sampleRate));
+            }
+
+            if (!(playbackRate > 0) || double.IsInfinity(playbackRate))
+            {
+                throw new ArgumentOutOfRangeException(nameof(playbackRate));
+            }
+        }
+
+        /// <summary>
+        /// Stretches a whole interleaved buffer at a fixed playback rate, rendering segments in parallel on
+        /// native worker threads plus the calling thread (as for StretchPool: 0 renders on the caller only, and a
+        /// negative count uses one thread per core). The result depends only on the input, settings and seed.
+        /// </summary>
+        public static float[] RenderOffline(float[] input, int channels, float sampleRate, double playbackRate, int threads = -1, long seed = 0)
+        {
+            unsafe
+            {
+                CheckRenderOffline(channels, sampleRate, playbackRate);
+                int inputFrames = input.Length / channels;
+                float[] output = new float[(long)Native.RenderOfflineLength(inputFrames, playbackRate) * channels];
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.RenderOffline(inputPtr, inputFrames, channels, sampleRate, playbackRate, threads, outputPtr, seed);
+                }
+
+                return output;
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        /// <summary>
+        /// Stretches a whole interleaved buffer at a fixed playback rate, rendering segments in parallel on
+        /// native worker threads plus the calling thread (as for StretchPool: 0 renders on the caller only, and a
+        /// negative count uses one thread per core). output must hold RenderOfflineLength(...) frames.
+        /// </summary>
+        public static void RenderOffline(ReadOnlySpan<float> input, int channels, float sampleRate, double playbackRate, Span<float> output, int threads = -1, long seed = 0)
+        {
+            unsafe
+            {
+                CheckRenderOffline(channels, sampleRate, playbackRate);
+                int inputFrames = input.Length / channels;
+                if (output.Length < (long)Native.RenderOfflineLength(inputFrames, playbackRate) * channels)
+                {
+                    throw new ArgumentException("Output buffer is too small.", nameof(output));
+                }
+
+                fixed (float* inputPtr = input)
+                fixed (float* outputPtr = output)
+                {
+                    Native.RenderOffline(inputPtr, inputFrames, channels, sampleRate, playbackRate, threads, outputPtr, seed);
+                }
+            }
+        }
+#endif
+
+        /// <summary>
+        /// Stretches a whole file at a fixed playback rate through this instance, reading and writing through windowed
+        /// memory maps so memory and address space use stay constant however long the file is. WAV input (PCM
+        /// 16/24/32-bit or float, with this instance's channel count and sample rate) is written as a 32-bit float WAV;
+        /// raw input is written as raw interleaved float32. The instance is reset before and after. Returns the number
+        /// of output frames, or -1 if a file could not be opened, created or mapped, the WAV format, channel count or
+        /// sample rate does not match, or the output would be too large.
+        /// </summary>
+        public long RenderFile(string inputPath, StretchFileFormat inputFormat, string outputPath, double playbackRate)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("Stretch");
+                }
+
+                fixed (byte* inputPathPtr = System.Text.Encoding.UTF8.GetBytes(inputPath + "\0"))
+                fixed (byte* outputPathPtr = System.Text.Encoding.UTF8.GetBytes(outputPath + "\0"))
+                {
+                    return Native.RenderFile(Handle, inputPathPtr, (int)inputFormat, outputPathPtr, playbackRate);
+                }
+            }
+        }
+
+        // Jobs are forwarded in fixed-size chunks so the native descriptor tables can live on the stack.
+        private const int BatchChunkSize = 64;
+
+        /// <summary>
+        /// Runs Process on many instances with a single native call per chunk of jobs.
+        /// </summary>
+        public static void ProcessBatch(StretchJob[] jobs)
+        {
+            unsafe
+            {
+                void** handles = stackalloc void*[BatchChunkSize];
+                ProcessJob* nativeJobs = stackalloc ProcessJob[BatchChunkSize];
+
+                for (int start = 0; start < jobs.Length; start += BatchChunkSize)
+                {
+                    int count = Math.Min(BatchChunkSize, jobs.Length - start);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        FillBatchJob(jobs[start + i], handles + i, nativeJobs + i);
+                    }
+
+                    Native.ProcessBatch(handles, nativeJobs, count);
+                }
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        /// <summary>
+        /// Runs Process on many instances with a single native call per chunk of jobs.
+        /// </summary>
+        public static void ProcessBatch(ReadOnlySpan<StretchJob> jobs)
+        {
+            unsafe
+            {
+                void** handles = stackalloc void*[BatchChunkSize];
+                ProcessJob* nativeJobs = stackalloc ProcessJob[BatchChunkSize];
+
+                for (int start = 0; start < jobs.Length; start += BatchChunkSize)
+                {
+                    int count = Math.Min(BatchChunkSize, jobs.Length - start);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        FillBatchJob(jobs[start + i], handles + i, nativeJobs + i);
+                    }
+
+                    Native.ProcessBatch(handles, nativeJobs, count);
+                }
+            }
+        }
+#endif
+
+        internal static unsafe void FillBatchJob(in StretchJob job, void** handle, ProcessJob* nativeJob)
+        {
+            if (job.Instance == null)
+            {
+                throw new ArgumentNullException(nameof(job.Instance));
+            }
+
+            if (job.Instance.Handle == null)
+            {
+                throw new ObjectDisposedException("Stretch");
+            }
+
+            *handle = job.Instance.Handle;
+            nativeJob->Input = job.Input;
+            nativeJob->InputSamples = job.InputLength;
+            nativeJob->Output = job.Output;
+            nativeJob->OutputSamples = job.OutputLength;
+        }
+
+        internal static unsafe void PinChannels(float[][] channels, GCHandle* handles, float** pointers)
+        {
+            for (int c = 0; c < channels.Length; ++c)
+            {
+                handles[c] = GCHandle.Alloc(channels[c], GCHandleType.Pinned);
+                pointers[c] = (float*)handles[c].AddrOfPinnedObject();
+            }
+        }
+
+        internal static unsafe void UnpinChannels(GCHandle* handles, int count)
+        {
+            for (int c = 0; c < count; ++c)
+            {
+                if (handles[c].IsAllocated)
+                {
+                    handles[c].Free();
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// A single Stretch.Process call for Stretch.ProcessBatch. Buffers are interleaved, as for Process,
+    /// and must stay pinned until ProcessBatch returns.
+    /// </summary>
+    public unsafe struct StretchJob
+    {
+        public Stretch Instance;
+        public float* Input;
+        public int InputLength;
+        public float* Output;
+        public int OutputLength;
+
+        public StretchJob(Stretch instance, float* input, int inputLength, float* output, int outputLength)
+        {
+            Instance = instance;
+            Input = input;
+            InputLength = inputLength;
+            Output = output;
+            OutputLength = outputLength;
+        }
+    }
+
+    /// <summary>
+    /// Process counters from Stretch.GetStats. Mirrors StretchStats in binding/mod.cpp.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StretchStats
+    {
+        public long Calls;
+        public long InputSamples;
+        public long OutputSamples;
+        /// <summary>Calls that took longer than BudgetMicroseconds.</summary>
+        public long OverBudget;
+        public double TotalMicroseconds;
+        public double MaxMicroseconds;
+        public double BudgetMicroseconds;
+    }
+
+    /// <summary>
+    /// Settings chosen by Stretch.ConfigureForLatency or reported by Stretch.GetLatencyConfig. Mirrors StretchLatencyConfig in binding/mod.cpp.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StretchLatencyConfig
+    {
+        public int BlockSamples;
+        public int IntervalSamples;
+        /// <summary>1 if split computation is on, otherwise 0.</summary>
+        public int SplitComputation;
+        public int InputLatency;
+        /// <summary>Includes the pipeline block if the instance is pipelined.</summary>
+        public int OutputLatency;
+        /// <summary>InputLatency + OutputLatency in milliseconds.</summary>
+        public float LatencyMs;
+    }
+
+    /// <summary>
+    /// Interpolation between the points given to Stretch.SetFreqMapTable.
+    /// </summary>
+    public enum FreqMapInterpolation
+    {
+        Linear = 0,
+        MonotoneCubic = 1,
+    }
+
+    /// <summary>
+    /// Input file layouts for Stretch.RenderFile. Raw files are interleaved with the instance's channel count.
+    /// </summary>
+    public enum StretchFileFormat
+    {
+        Wav = 0,
+        RawFloat32 = 1,
+        RawInt16 = 2,
+    }
+
+    /// <summary>
+    /// Parameter snapshot for Stretch.PostParams. Mirrors StretchParams in binding/mod.cpp.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StretchParams
+    {
+        public float TransposeFactor;
+        public float TonalityLimit;
+        public float FormantFactor;
+        /// <summary>0 estimates the formant base automatically.</summary>
+        public float FormantBase;
+        public int FormantCompensatePitch;
+        /// <summary>Input samples per output sample, used by ParamsInputSamples.</summary>
+        public float Rate;
+        /// <summary>Time constant for gliding to new values, or 0 to jump.</summary>
+        public float SmoothingMs;
+
+        public StretchParams(float transposeFactor, float formantFactor = 1, float rate = 1, float smoothingMs = 20)
+        {
+            TransposeFactor = transposeFactor;
+            TonalityLimit = 0;
+            FormantFactor = formantFactor;
+            FormantBase = 0;
+            FormantCompensatePitch = 0;
+            Rate = rate;
+            SmoothingMs = smoothingMs;
+        }
+    }
+
+    // Mirrors ProcessJob in binding/mod.cpp
+    [StructLayout(LayoutKind.Sequential)]
+    internal unsafe struct ProcessJob
+    {
+        public float* Input;
+        public int InputSamples;
+        public float* Output;
+        public int OutputSamples;
+    }
+
+    internal static partial class Native
+    {
+        public const string DllName = "SignalsmithStretch";
+
+#if NET7_0_OR_GREATER
+        [LibraryImport(DllName, EntryPoint = "Stretch_Create")]
+        public static unsafe partial void* Create();
+        [LibraryImport(DllName, EntryPoint = "Stretch_CreateSeed")]
+        public static unsafe partial void* CreateSeed(long seed);
         [LibraryImport(DllName, EntryPoint = "Stretch_Release")]
         public static unsafe partial void Release(void* stretch);
         [LibraryImport(DllName, EntryPoint = "Stretch_PresetDefault")]
@@ -616,6 +1837,89 @@ namespace Signalsmith
         [LibraryImport(DllName, EntryPoint = "Stretch_Exact")]
         [return: MarshalAs(UnmanagedType.I1)]
         public static unsafe partial bool Exact(void* stretch, float* input, int pcmLength, float* output, int pcmOutLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SeekPlanar")]
+        public static unsafe partial void SeekPlanar(void* stretch, float** input, int pcmLength, double playbackRate);
+        [LibraryImport(DllName, EntryPoint = "Stretch_FlushPlanar")]
+        public static unsafe partial void FlushPlanar(void* stretch, float** output, int pcmOutLength, double playbackRate);
+        [LibraryImport(DllName, EntryPoint = "Stretch_OutputSeekPlanar")]
+        public static unsafe partial void OutputSeekPlanar(void* stretch, float** input, int inputLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ProcessPlanar")]
+        public static unsafe partial void ProcessPlanar(void* stretch, float** input, int pcmLength, float** output, int pcmOutLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ExactPlanar")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool ExactPlanar(void* stretch, float** input, int pcmLength, float** output, int pcmOutLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ProcessBatch")]
+        public static unsafe partial void ProcessBatch(void** instances, ProcessJob* jobs, int count);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetPipelined")]
+        public static unsafe partial void SetPipelined(void* stretch, int maxBlockSamples);
+        [LibraryImport(DllName, EntryPoint = "Stretch_Pipelined")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool Pipelined(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_PipelineUnderruns")]
+        public static unsafe partial int PipelineUnderruns(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_RenderOfflineLength")]
+        public static partial long RenderOfflineLength(long inputFrames, double playbackRate);
+        [LibraryImport(DllName, EntryPoint = "Stretch_RenderOffline")]
+        public static unsafe partial void RenderOffline(float* input, long inputFrames, int channels, float sampleRate, double playbackRate, int threads, float* output, long seed);
+        [LibraryImport(DllName, EntryPoint = "Stretch_PostParams")]
+        public static unsafe partial void PostParams(void* stretch, StretchParams* parameters);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ProcessParams")]
+        public static unsafe partial void ProcessParams(void* stretch, float* input, int pcmLength, float* output, int pcmOutLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ProcessParamsPlanar")]
+        public static unsafe partial void ProcessParamsPlanar(void* stretch, float** input, int pcmLength, float** output, int pcmOutLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ParamsInputSamples")]
+        public static unsafe partial int ParamsInputSamples(void* stretch, int outputSamples);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetFreqMapTable")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool SetFreqMapTable(void* stretch, float* inputFreqs, float* outputFreqs, int points, int interpolation);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetFreqMapScale")]
+        public static unsafe partial void SetFreqMapScale(void* stretch, float rootHz, float* degrees, int count, float transposeSemitones, float strength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_MemoryFootprint")]
+        public static unsafe partial UIntPtr MemoryFootprint(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SharedMemoryFootprint")]
+        public static partial UIntPtr SharedMemoryFootprint();
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetAllocator")]
+        public static unsafe partial void SetAllocator(delegate* unmanaged<void*, UIntPtr, void*> alloc, delegate* unmanaged<void*, void*, void> free, void* userData);
+        [LibraryImport(DllName, EntryPoint = "Stretch_AllocationCount")]
+        public static partial UIntPtr AllocationCount();
+        [LibraryImport(DllName, EntryPoint = "Stretch_AllocationsSinceConfigure")]
+        public static unsafe partial UIntPtr AllocationsSinceConfigure(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_GetStats")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool GetStats(void* stretch, StretchStats* stats);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ResetStats")]
+        public static unsafe partial void ResetStats(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetStatsBudget")]
+        public static unsafe partial void SetStatsBudget(void* stretch, double microseconds);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ProcessFormat")]
+        public static unsafe partial void ProcessFormat(void* stretch, void* input, int format, int pcmLength, float* output, int pcmOutLength);
+        [LibraryImport(DllName, EntryPoint = "Stretch_RenderStart")]
+        public static unsafe partial void RenderStart(void* stretch, delegate* unmanaged<void*, float*, int, int> read, void* userData);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetRenderRate")]
+        public static unsafe partial void SetRenderRate(void* stretch, double rate);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetRenderTimeMap")]
+        public static unsafe partial void SetRenderTimeMap(void* stretch, double* outputFrames, double* inputFrames, int points, double rateAfter);
+        [LibraryImport(DllName, EntryPoint = "Stretch_Render")]
+        public static unsafe partial int Render(void* stretch, float* output, int frames);
+        [LibraryImport(DllName, EntryPoint = "Stretch_RenderInputPosition")]
+        public static unsafe partial double RenderInputPosition(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_RenderFile")]
+        public static unsafe partial long RenderFile(void* stretch, byte* inputPath, int inputFormat, byte* outputPath, double playbackRate);
+        [LibraryImport(DllName, EntryPoint = "Stretch_ConfigureForLatency")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool ConfigureForLatency(void* stretch, int channels, float sampleRate, float maxLatencyMs, float cpuBudget, StretchLatencyConfig* chosen);
+        [LibraryImport(DllName, EntryPoint = "Stretch_PresetLowLatency")]
+        public static unsafe partial void PresetLowLatency(void* stretch, int channels, float sampleRate, [MarshalAs(UnmanagedType.I1)] bool splitComputation);
+        [LibraryImport(DllName, EntryPoint = "Stretch_GetLatencyConfig")]
+        public static unsafe partial void GetLatencyConfig(void* stretch, StretchLatencyConfig* config);
+        [LibraryImport(DllName, EntryPoint = "Stretch_EnableQualityTiers")]
+        public static unsafe partial void EnableQualityTiers(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetQualityTier")]
+        public static unsafe partial void SetQualityTier(void* stretch, int tier);
+        [LibraryImport(DllName, EntryPoint = "Stretch_GetQualityTier")]
+        public static unsafe partial int GetQualityTier(void* stretch);
+        [LibraryImport(DllName, EntryPoint = "Stretch_SetCpuBudget")]
+        public static unsafe partial void SetCpuBudget(void* stretch, float microsecondsPerBlock);
 #else
         [DllImport(DllName, EntryPoint = "Stretch_Create")]
         public extern static unsafe void* Create();
@@ -670,6 +1974,89 @@ namespace Signalsmith
         [DllImport(DllName, EntryPoint = "Stretch_Exact")]
         [return: MarshalAs(UnmanagedType.I1)]
         public extern static unsafe bool Exact(void* stretch, float* input, int pcmLength, float* output, int pcmOutLength);
+        [DllImport(DllName, EntryPoint = "Stretch_SeekPlanar")]
+        public extern static unsafe void SeekPlanar(void* stretch, float** input, int pcmLength, double playbackRate);
+        [DllImport(DllName, EntryPoint = "Stretch_FlushPlanar")]
+        public extern static unsafe void FlushPlanar(void* stretch, float** output, int pcmOutLength, double playbackRate);
+        [DllImport(DllName, EntryPoint = "Stretch_OutputSeekPlanar")]
+        public extern static unsafe void OutputSeekPlanar(void* stretch, float** input, int inputLength);
+        [DllImport(DllName, EntryPoint = "Stretch_ProcessPlanar")]
+        public extern static unsafe void ProcessPlanar(void* stretch, float** input, int pcmLength, float** output, int pcmOutLength);
+        [DllImport(DllName, EntryPoint = "Stretch_ExactPlanar")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public extern static unsafe bool ExactPlanar(void* stretch, float** input, int pcmLength, float** output, int pcmOutLength);
+        [DllImport(DllName, EntryPoint = "Stretch_ProcessBatch")]
+        public extern static unsafe void ProcessBatch(void** instances, ProcessJob* jobs, int count);
+        [DllImport(DllName, EntryPoint = "Stretch_SetPipelined")]
+        public extern static unsafe void SetPipelined(void* stretch, int maxBlockSamples);
+        [DllImport(DllName, EntryPoint = "Stretch_Pipelined")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public extern static unsafe bool Pipelined(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_PipelineUnderruns")]
+        public extern static unsafe int PipelineUnderruns(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_RenderOfflineLength")]
+        public extern static long RenderOfflineLength(long inputFrames, double playbackRate);
+        [DllImport(DllName, EntryPoint = "Stretch_RenderOffline")]
+        public extern static unsafe void RenderOffline(float* input, long inputFrames, int channels, float sampleRate, double playbackRate, int threads, float* output, long seed);
+        [DllImport(DllName, EntryPoint = "Stretch_PostParams")]
+        public extern static unsafe void PostParams(void* stretch, StretchParams* parameters);
+        [DllImport(DllName, EntryPoint = "Stretch_ProcessParams")]
+        public extern static unsafe void ProcessParams(void* stretch, float* input, int pcmLength, float* output, int pcmOutLength);
+        [DllImport(DllName, EntryPoint = "Stretch_ProcessParamsPlanar")]
+        public extern static unsafe void ProcessParamsPlanar(void* stretch, float** input, int pcmLength, float** output, int pcmOutLength);
+        [DllImport(DllName, EntryPoint = "Stretch_ParamsInputSamples")]
+        public extern static unsafe int ParamsInputSamples(void* stretch, int outputSamples);
+        [DllImport(DllName, EntryPoint = "Stretch_SetFreqMapTable")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public extern static unsafe bool SetFreqMapTable(void* stretch, float* inputFreqs, float* outputFreqs, int points, int interpolation);
+        [DllImport(DllName, EntryPoint = "Stretch_SetFreqMapScale")]
+        public extern static unsafe void SetFreqMapScale(void* stretch, float rootHz, float* degrees, int count, float transposeSemitones, float strength);
+        [DllImport(DllName, EntryPoint = "Stretch_MemoryFootprint")]
+        public extern static unsafe UIntPtr MemoryFootprint(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_SharedMemoryFootprint")]
+        public extern static UIntPtr SharedMemoryFootprint();
+        [DllImport(DllName, EntryPoint = "Stretch_SetAllocator")]
+        public extern static unsafe void SetAllocator(IntPtr alloc, IntPtr free, void* userData);
+        [DllImport(DllName, EntryPoint = "Stretch_AllocationCount")]
+        public extern static UIntPtr AllocationCount();
+        [DllImport(DllName, EntryPoint = "Stretch_AllocationsSinceConfigure")]
+        public extern static unsafe UIntPtr AllocationsSinceConfigure(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_GetStats")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public extern static unsafe bool GetStats(void* stretch, StretchStats* stats);
+        [DllImport(DllName, EntryPoint = "Stretch_ResetStats")]
+        public extern static unsafe void ResetStats(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_SetStatsBudget")]
+        public extern static unsafe void SetStatsBudget(void* stretch, double microseconds);
+        [DllImport(DllName, EntryPoint = "Stretch_ProcessFormat")]
+        public extern static unsafe void ProcessFormat(void* stretch, void* input, int format, int pcmLength, float* output, int pcmOutLength);
+        [DllImport(DllName, EntryPoint = "Stretch_RenderStart")]
+        public extern static unsafe void RenderStart(void* stretch, IntPtr read, void* userData);
+        [DllImport(DllName, EntryPoint = "Stretch_SetRenderRate")]
+        public extern static unsafe void SetRenderRate(void* stretch, double rate);
+        [DllImport(DllName, EntryPoint = "Stretch_SetRenderTimeMap")]
+        public extern static unsafe void SetRenderTimeMap(void* stretch, double* outputFrames, double* inputFrames, int points, double rateAfter);
+        [DllImport(DllName, EntryPoint = "Stretch_Render")]
+        public extern static unsafe int Render(void* stretch, float* output, int frames);
+        [DllImport(DllName, EntryPoint = "Stretch_RenderInputPosition")]
+        public extern static unsafe double RenderInputPosition(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_RenderFile")]
+        public extern static unsafe long RenderFile(void* stretch, byte* inputPath, int inputFormat, byte* outputPath, double playbackRate);
+        [DllImport(DllName, EntryPoint = "Stretch_ConfigureForLatency")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public extern static unsafe bool ConfigureForLatency(void* stretch, int channels, float sampleRate, float maxLatencyMs, float cpuBudget, StretchLatencyConfig* chosen);
+        [DllImport(DllName, EntryPoint = "Stretch_PresetLowLatency")]
+        public extern static unsafe void PresetLowLatency(void* stretch, int channels, float sampleRate, [MarshalAs(UnmanagedType.I1)] bool splitComputation);
+        [DllImport(DllName, EntryPoint = "Stretch_GetLatencyConfig")]
+        public extern static unsafe void GetLatencyConfig(void* stretch, StretchLatencyConfig* config);
+        [DllImport(DllName, EntryPoint = "Stretch_EnableQualityTiers")]
+        public extern static unsafe void EnableQualityTiers(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_SetQualityTier")]
+        public extern static unsafe void SetQualityTier(void* stretch, int tier);
+        [DllImport(DllName, EntryPoint = "Stretch_GetQualityTier")]
+        public extern static unsafe int GetQualityTier(void* stretch);
+        [DllImport(DllName, EntryPoint = "Stretch_SetCpuBudget")]
+        public extern static unsafe void SetCpuBudget(void* stretch, float microsecondsPerBlock);
 #endif
     }   
 }
\ No newline at end of file
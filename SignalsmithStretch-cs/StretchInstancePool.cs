@@ -0,0 +1,155 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Signalsmith
+{
+    public enum StretchPreset
+    {
+        Default = 0,
+        Cheaper = 1,
+        LowLatency = 2,
+    }
+
+    /// <summary>
+    /// Fixed set of preconfigured native Stretch instances, rented and returned without locks or native allocation.
+    /// Disposing a rented Stretch resets it and hands it back to the pool.
+    /// </summary>
+    public class StretchInstancePool : IDisposable
+    {
+        public unsafe void* Handle;
+
+        public StretchInstancePool(int count, int channels, float sampleRate, StretchPreset preset = StretchPreset.Default, bool splitComputation = false, long seed = 0)
+        {
+            unsafe
+            {
+                Handle = Native.StretchInstancePool_Create(count, channels, sampleRate, (int)preset, splitComputation, seed);
+
+                if (Handle == null)
+                {
+                    throw new Exception("Failed to create StretchInstancePool instance.");
+                }
+            }
+        }
+
+        ~StretchInstancePool()
+        {
+            Release();
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// Frees every instance. Any Stretch still rented from the pool must not be used afterwards.
+        /// </summary>
+        public void Release()
+        {
+            unsafe
+            {
+                if (Handle != null)
+                {
+                    Native.StretchInstancePool_Release(Handle);
+                    Handle = null;
+                }
+            }
+        }
+
+        public int Capacity()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchInstancePool");
+                }
+
+                return Native.StretchInstancePool_Capacity(Handle);
+            }
+        }
+
+        public int Available()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchInstancePool");
+                }
+
+                return Native.StretchInstancePool_Available(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Takes a ready-to-use instance from the pool, or returns null if they are all rented.
+        /// </summary>
+        public Stretch Rent()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchInstancePool");
+                }
+
+                void* stretch = Native.StretchInstancePool_Rent(Handle);
+                return stretch == null ? null : new Stretch(stretch, this);
+            }
+        }
+
+        internal unsafe void Return(void* stretch)
+        {
+            // After the pool is released its instances are gone, so late returns (e.g. from finalizers) are dropped
+            if (Handle != null)
+            {
+                Native.StretchInstancePool_Return(Handle, stretch);
+            }
+        }
+    }
+
+    internal static partial class Native
+    {
+#if NET7_0_OR_GREATER
+        [LibraryImport(DllName, EntryPoint = "StretchInstancePool_Create")]
+        public static unsafe partial void* StretchInstancePool_Create(int count, int channels, float sampleRate, int preset, [MarshalAs(UnmanagedType.I1)] bool splitComputation, long seed);
+
+        [LibraryImport(DllName, EntryPoint = "StretchInstancePool_Release")]
+        public static unsafe partial void StretchInstancePool_Release(void* pool);
+
+        [LibraryImport(DllName, EntryPoint = "StretchInstancePool_Capacity")]
+        public static unsafe partial int StretchInstancePool_Capacity(void* pool);
+
+        [LibraryImport(DllName, EntryPoint = "StretchInstancePool_Available")]
+        public static unsafe partial int StretchInstancePool_Available(void* pool);
+
+        [LibraryImport(DllName, EntryPoint = "StretchInstancePool_Rent")]
+        public static unsafe partial void* StretchInstancePool_Rent(void* pool);
+
+        [LibraryImport(DllName, EntryPoint = "StretchInstancePool_Return")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static unsafe partial bool StretchInstancePool_Return(void* pool, void* stretch);
+#else
+        [DllImport(DllName, EntryPoint = "StretchInstancePool_Create")]
+        public static extern unsafe void* StretchInstancePool_Create(int count, int channels, float sampleRate, int preset, [MarshalAs(UnmanagedType.I1)] bool splitComputation, long seed);
+
+        [DllImport(DllName, EntryPoint = "StretchInstancePool_Release")]
+        public static extern unsafe void StretchInstancePool_Release(void* pool);
+
+        [DllImport(DllName, EntryPoint = "StretchInstancePool_Capacity")]
+        public static extern unsafe int StretchInstancePool_Capacity(void* pool);
+
+        [DllImport(DllName, EntryPoint = "StretchInstancePool_Available")]
+        public static extern unsafe int StretchInstancePool_Available(void* pool);
+
+        [DllImport(DllName, EntryPoint = "StretchInstancePool_Rent")]
+        public static extern unsafe void* StretchInstancePool_Rent(void* pool);
+
+        [DllImport(DllName, EntryPoint = "StretchInstancePool_Return")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern unsafe bool StretchInstancePool_Return(void* pool, void* stretch);
+#endif
+    }
+}
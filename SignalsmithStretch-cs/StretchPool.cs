@@ -0,0 +1,199 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Signalsmith
+{
+    /// <summary>
+    /// Native worker pool that runs batches of independent Stretch.Process jobs across threads.
+    /// </summary>
+    public class StretchPool : IDisposable
+    {
+        public unsafe void* Handle;
+
+        // Native copies of the job descriptors, grown on demand and reused between submits
+        private unsafe void** handleTable;
+        private unsafe ProcessJob* jobTable;
+        private int tableCapacity;
+
+        /// <summary>
+        /// Creates a pool with the given number of worker threads. The thread calling Wait also takes part,
+        /// so 0 runs everything on the caller. A negative count uses one worker per core, minus the caller.
+        /// </summary>
+        public StretchPool(int threads = -1)
+        {
+            unsafe
+            {
+                Handle = Native.StretchPool_Create(threads);
+
+                if (Handle == null)
+                {
+                    throw new Exception("Failed to create StretchPool instance.");
+                }
+            }
+        }
+
+        ~StretchPool()
+        {
+            Release();
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        public void Release()
+        {
+            unsafe
+            {
+                if (Handle != null)
+                {
+                    Native.StretchPool_Release(Handle);
+                    Handle = null;
+                }
+
+                if (handleTable != null)
+                {
+                    Marshal.FreeHGlobal((IntPtr)handleTable);
+                    Marshal.FreeHGlobal((IntPtr)jobTable);
+                    handleTable = null;
+                    jobTable = null;
+                    tableCapacity = 0;
+                }
+            }
+        }
+
+        public int Threads()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchPool");
+                }
+
+                return Native.StretchPool_Threads(Handle);
+            }
+        }
+
+        /// <summary>
+        /// Starts a batch on the worker threads and returns immediately. Each instance may appear at most once,
+        /// and buffers must stay pinned until Wait returns.
+        /// </summary>
+        public void Submit(StretchJob[] jobs)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchPool");
+                }
+
+                EnsureCapacity(jobs.Length);
+                for (int i = 0; i < jobs.Length; ++i)
+                {
+                    Stretch.FillBatchJob(jobs[i], handleTable + i, jobTable + i);
+                }
+
+                Native.StretchPool_Submit(Handle, handleTable, jobTable, jobs.Length);
+            }
+        }
+
+#if NET7_0_OR_GREATER
+        /// <summary>
+        /// Starts a batch on the worker threads and returns immediately. Each instance may appear at most once,
+        /// and buffers must stay pinned until Wait returns.
+        /// </summary>
+        public void Submit(ReadOnlySpan<StretchJob> jobs)
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchPool");
+                }
+
+                EnsureCapacity(jobs.Length);
+                for (int i = 0; i < jobs.Length; ++i)
+                {
+                    Stretch.FillBatchJob(jobs[i], handleTable + i, jobTable + i);
+                }
+
+                Native.StretchPool_Submit(Handle, handleTable, jobTable, jobs.Length);
+            }
+        }
+#endif
+
+        /// <summary>
+        /// Helps process the current batch on the calling thread, then spins until the jobs still running on
+        /// workers have finished. Neither Submit nor Wait takes a lock, so both are safe on an audio thread.
+        /// </summary>
+        public void Wait()
+        {
+            unsafe
+            {
+                if (Handle == null)
+                {
+                    throw new ObjectDisposedException("StretchPool");
+                }
+
+                Native.StretchPool_Wait(Handle);
+            }
+        }
+
+        private unsafe void EnsureCapacity(int count)
+        {
+            if (count <= tableCapacity)
+            {
+                return;
+            }
+
+            if (handleTable != null)
+            {
+                Native.StretchPool_Wait(Handle);
+                Marshal.FreeHGlobal((IntPtr)handleTable);
+                Marshal.FreeHGlobal((IntPtr)jobTable);
+            }
+
+            handleTable = (void**)Marshal.AllocHGlobal(count * sizeof(void*));
+            jobTable = (ProcessJob*)Marshal.AllocHGlobal(count * sizeof(ProcessJob));
+            tableCapacity = count;
+        }
+    }
+
+    internal static partial class Native
+    {
+#if NET7_0_OR_GREATER
+        [LibraryImport(DllName, EntryPoint = "StretchPool_Create")]
+        public static unsafe partial void* StretchPool_Create(int threads);
+
+        [LibraryImport(DllName, EntryPoint = "StretchPool_Release")]
+        public static unsafe partial void StretchPool_Release(void* pool);
+
+        [LibraryImport(DllName, EntryPoint = "StretchPool_Threads")]
+        public static unsafe partial int StretchPool_Threads(void* pool);
+
+        [LibraryImport(DllName, EntryPoint = "StretchPool_Submit")]
+        public static unsafe partial void StretchPool_Submit(void* pool, void** instances, ProcessJob* jobs, int count);
+
+        [LibraryImport(DllName, EntryPoint = "StretchPool_Wait")]
+        public static unsafe partial void StretchPool_Wait(void* pool);
+#else
+        [DllImport(DllName, EntryPoint = "StretchPool_Create")]
+        public static extern unsafe void* StretchPool_Create(int threads);
+
+        [DllImport(DllName, EntryPoint = "StretchPool_Release")]
+        public static extern unsafe void StretchPool_Release(void* pool);
+
+        [DllImport(DllName, EntryPoint = "StretchPool_Threads")]
+        public static extern unsafe int StretchPool_Threads(void* pool);
+
+        [DllImport(DllName, EntryPoint = "StretchPool_Submit")]
+        public static extern unsafe void StretchPool_Submit(void* pool, void** instances, ProcessJob* jobs, int count);
+
+        [DllImport(DllName, EntryPoint = "StretchPool_Wait")]
+        public static extern unsafe void StretchPool_Wait(void* pool);
+#endif
+    }
+}
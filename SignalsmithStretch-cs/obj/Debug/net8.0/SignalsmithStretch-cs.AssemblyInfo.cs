@@ -0,0 +1,24 @@
+//------------------------------------------------------------------------------
+// <auto-generated>
+//     This code was generated by a tool.
+//
+//     Changes to this file may cause incorrect behavior and will be lost if
+//     the code is regenerated.
+// </auto-generated>
+//------------------------------------------------------------------------------
+
+using System;
+using System.Reflection;
+
+[assembly: System.Reflection.AssemblyCompanyAttribute("Estrol")]
+[assembly: System.Reflection.AssemblyConfigurationAttribute("Debug")]
+[assembly: System.Reflection.AssemblyDescriptionAttribute("C# wrapper for Signalsmith-Stretch")]
+[assembly: System.Reflection.AssemblyFileVersionAttribute("1.1.2.0")]
+[assembly: System.Reflection.AssemblyInformationalVersionAttribute("1.1.2+1215ee6dc3664d7b0f831521b6926388fe35cf30")]
+[assembly: System.Reflection.AssemblyProductAttribute("SignalsmithStretch-cs")]
+[assembly: System.Reflection.AssemblyTitleAttribute("SignalsmithStretch-cs")]
+[assembly: System.Reflection.AssemblyVersionAttribute("1.1.2.0")]
+[assembly: System.Reflection.AssemblyMetadataAttribute("RepositoryUrl", "https://github.com/Estrol/signalsmith-stretch-cs")]
+
+// Generated by the MSBuild WriteCodeFragment class.
+
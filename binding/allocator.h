@@ -0,0 +1,83 @@
+// Allocation hooks shared by mod.cpp, fft.cpp and stft.cpp.
+// The binding's own objects and buffers (hookNew and HookVector) go through Binding_Allocate/Binding_Free, which use
+// the hooks given to Stretch_SetAllocator. Memory allocated inside signalsmith-stretch and signalsmith-linear (the
+// stretcher's, STFT's and FFT's internal buffers), std::function targets, and thread start-up state still come from
+// the default heap.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+void* Binding_Allocate(size_t bytes);
+void Binding_Free(void* pointer);
+
+// Each instance counts the hook allocations made on its behalf (Stretch_AllocationsSinceConfigure and
+// STFT_AllocationsSinceConfigure). An allocation is charged to the innermost AllocationScope on the calling thread.
+typedef std::atomic<size_t> AllocationCounter;
+
+AllocationCounter* Binding_SwapAllocationCounter(AllocationCounter* counter);
+
+class AllocationScope {
+    AllocationCounter* previous;
+public:
+    explicit AllocationScope(AllocationCounter& counter) : previous(Binding_SwapAllocationCounter(&counter)) {}
+    ~AllocationScope() {
+        Binding_SwapAllocationCounter(previous);
+    }
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+// Restarts the count of the instance in scope, called once it is set up
+void Binding_Configured();
+
+template<typename T>
+struct HookAllocator {
+    typedef T value_type;
+
+    HookAllocator() {}
+    template<typename U>
+    HookAllocator(const HookAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(Binding_Allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t) {
+        Binding_Free(pointer);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const HookAllocator<T>&, const HookAllocator<U>&) {
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const HookAllocator<T>&, const HookAllocator<U>&) {
+    return false;
+}
+
+template<typename T>
+using HookVector = std::vector<T, HookAllocator<T>>;
+
+template<typename T, typename... Args>
+T* hookNew(Args&&... args) {
+    void* memory = Binding_Allocate(sizeof(T));
+    try {
+        return new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        Binding_Free(memory);
+        throw;
+    }
+}
+
+template<typename T>
+void hookDelete(T* object) {
+    if (!object) return;
+    object->~T();
+    Binding_Free(object);
+}
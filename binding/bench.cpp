@@ -0,0 +1,268 @@
+// Throughput/latency benchmark for the C ABI exported by this library.
+//
+//     stretch_bench [--quick] [--out results.json]
+//
+// Every case times individual calls, and reports samples/sec plus p50/p99/max call latency as JSON.
+// Samples are counted per channel, so multichannel cases are comparable to mono ones.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Stretch;
+struct FFT;
+class BaseSTFT;
+
+extern "C" {
+    Stretch* Stretch_CreateSeed(long seed);
+    void Stretch_Release(Stretch* stretch);
+    void Stretch_PresetDefault(Stretch* stretch, int nChannels, float sampleRate, bool splitComputation);
+    void Stretch_PresetCheaper(Stretch* stretch, int nChannels, float sampleRate, bool splitComputation);
+    void Stretch_Process(Stretch* stretch, float* input, int pcmLength, float* output, int pcmOutLength);
+
+    FFT* FFT_Create(size_t size);
+    void FFT_Delete(FFT* fft);
+    void FFT_Proc(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag);
+    void FFT_ProcSplit(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag);
+    void FFT_ProcComplex(FFT* fft, const float* interleavedInput, float* interleavedOutput);
+    void FFT_ProcBatch(FFT* fft, int frames, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag, size_t strideFrames);
+
+    BaseSTFT* STFT_Create(bool splitComputation);
+    void STFT_Delete(BaseSTFT* stft);
+    void STFT_Configure(BaseSTFT* stft, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry);
+    void STFT_WriteInput(BaseSTFT* stft, size_t channel, size_t offset, size_t length, const float* inputArray);
+    void STFT_MoveInput(BaseSTFT* stft, size_t samples, bool clearMovedRegion);
+    void STFT_Analyse(BaseSTFT* stft, size_t sampleInPast);
+    void STFT_Synthesise(BaseSTFT* stft);
+    void STFT_ReadOutput(BaseSTFT* stft, size_t channel, size_t offset, size_t length, float* outputArray);
+    void STFT_MoveOutput(BaseSTFT* stft, size_t samples);
+
+    void Convert_Deinterleave(const void* interleaved, int format, int channels, size_t length, float* const* planar);
+    void Convert_Interleave(const float* const* planar, int channels, size_t length, float* interleaved);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const float sampleRate = 48000;
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    double samplesPerSecond;
+    double p50, p99, max; // microseconds per call
+};
+
+std::vector<Result> results;
+
+// Calls `step` `warmup` times untimed, then `iterations` times timed, each call processing `samplesPerCall` samples
+template<class Step>
+void measure(const std::string& name, size_t warmup, size_t iterations, double samplesPerCall, Step step) {
+    for (size_t i = 0; i < warmup; ++i) {
+        step();
+    }
+
+    std::vector<double> durations(iterations);
+    double total = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        Clock::time_point start = Clock::now();
+        step();
+        double micros = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        durations[i] = micros;
+        total += micros;
+    }
+    std::sort(durations.begin(), durations.end());
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.samplesPerSecond = total > 0 ? samplesPerCall * iterations / (total * 1e-6) : 0;
+    result.p50 = durations[iterations / 2];
+    result.p99 = durations[std::min(iterations - 1, iterations * 99 / 100)];
+    result.max = durations.back();
+    results.push_back(result);
+
+    fprintf(stderr, "%-60s %12.0f samples/s  p50 %8.2fus  p99 %8.2fus  max %8.2fus\n", name.c_str(), result.samplesPerSecond, result.p50, result.p99, result.max);
+}
+
+void fillNoise(std::vector<float>& buffer) {
+    unsigned state = 12345;
+    for (float& sample : buffer) {
+        state = state * 1664525u + 1013904223u;
+        sample = (float)(state >> 8) / (float)(1 << 24) * 2 - 1;
+    }
+}
+
+void benchStretch(double seconds) {
+    const int channelCounts[] = {1, 2, 8};
+    const int blockSizes[] = {64, 256, 1024};
+
+    for (int cheaper = 0; cheaper < 2; ++cheaper) {
+        for (int split = 0; split < 2; ++split) {
+            for (int channels : channelCounts) {
+                for (int block : blockSizes) {
+                    Stretch* stretch = Stretch_CreateSeed(0);
+                    if (cheaper) {
+                        Stretch_PresetCheaper(stretch, channels, sampleRate, split != 0);
+                    } else {
+                        Stretch_PresetDefault(stretch, channels, sampleRate, split != 0);
+                    }
+
+                    std::vector<float> input((size_t)block * channels), output((size_t)block * channels);
+                    fillNoise(input);
+
+                    char name[128];
+                    snprintf(name, sizeof(name), "Stretch_Process/preset:%s/split:%d/channels:%d/block:%d", cheaper ? "cheaper" : "default", split, channels, block);
+                    size_t iterations = std::max<size_t>(16, (size_t)(seconds * sampleRate / block));
+                    measure(name, iterations / 8, iterations, (double)block * channels, [&]() {
+                        Stretch_Process(stretch, input.data(), block, output.data(), block);
+                    });
+
+                    Stretch_Release(stretch);
+                }
+            }
+        }
+    }
+}
+
+void benchFFT(size_t iterations) {
+    const size_t sizes[] = {256, 1024, 4096};
+
+    for (size_t size : sizes) {
+        FFT* fft = FFT_Create(size);
+
+        std::vector<float> inReal(size), inImag(size), outReal(size), outImag(size);
+        std::vector<float> inComplex(size * 2), outComplex(size * 2);
+        fillNoise(inReal);
+        fillNoise(inImag);
+        fillNoise(inComplex);
+
+        measure("FFT_Proc/size:" + std::to_string(size), iterations / 8, iterations, (double)size, [&]() {
+            FFT_Proc(fft, inReal.data(), inImag.data(), outReal.data(), outImag.data());
+        });
+        measure("FFT_ProcSplit/size:" + std::to_string(size), iterations / 8, iterations, (double)size, [&]() {
+            FFT_ProcSplit(fft, inReal.data(), inImag.data(), outReal.data(), outImag.data());
+        });
+        measure("FFT_ProcComplex/size:" + std::to_string(size), iterations / 8, iterations, (double)size, [&]() {
+            FFT_ProcComplex(fft, inComplex.data(), outComplex.data());
+        });
+
+
+        const int batchFrames = 16;
+        std::vector<float> batchReal(size * batchFrames), batchImag(size * batchFrames), batchOutReal(size * batchFrames), batchOutImag(size * batchFrames);
+        fillNoise(batchReal);
+        fillNoise(batchImag);
+        measure("FFT_ProcBatch/size:" + std::to_string(size) + "/frames:" + std::to_string(batchFrames), iterations / 64, iterations / 8, (double)size * batchFrames, [&]() {
+            FFT_ProcBatch(fft, batchFrames, batchReal.data(), batchImag.data(), batchOutReal.data(), batchOutImag.data(), 0);
+        });
+
+        FFT_Delete(fft);
+    }
+}
+
+void benchSTFT(size_t iterations) {
+    const int channelCounts[] = {1, 2, 8};
+    const int blockSizes[] = {1024, 4096};
+
+    for (int split = 0; split < 2; ++split) {
+        for (int channels : channelCounts) {
+            for (int block : blockSizes) {
+                int interval = block / 4;
+                BaseSTFT* stft = STFT_Create(split != 0);
+                STFT_Configure(stft, channels, channels, block, 0, interval, 0);
+
+                std::vector<float> buffer(interval);
+                fillNoise(buffer);
+
+                char name[128];
+                snprintf(name, sizeof(name), "STFT_Analyse/split:%d/channels:%d/block:%d", split, channels, block);
+                measure(name, iterations / 8, iterations, (double)interval * channels, [&]() {
+                    for (int c = 0; c < channels; ++c) {
+                        STFT_WriteInput(stft, c, 0, interval, buffer.data());
+                    }
+                    STFT_MoveInput(stft, interval, false);
+                    STFT_Analyse(stft, 0);
+                });
+
+                snprintf(name, sizeof(name), "STFT_Synthesise/split:%d/channels:%d/block:%d", split, channels, block);
+                measure(name, iterations / 8, iterations, (double)interval * channels, [&]() {
+                    STFT_Synthesise(stft);
+                    for (int c = 0; c < channels; ++c) {
+                        STFT_ReadOutput(stft, c, 0, interval, buffer.data());
+                    }
+                    STFT_MoveOutput(stft, interval);
+                });
+
+                STFT_Delete(stft);
+            }
+        }
+    }
+}
+
+void benchConvert(size_t iterations) {
+    const int channelCounts[] = {2, 6, 8};
+    const size_t length = 1024;
+
+    for (int channels : channelCounts) {
+        std::vector<float> interleaved(length * channels);
+        std::vector<short> interleaved16(length * channels);
+        std::vector<float> planar(length * channels);
+        std::vector<float*> pointers(channels);
+        for (int c = 0; c < channels; ++c) pointers[c] = planar.data() + c * length;
+        fillNoise(interleaved);
+
+        measure("Convert_Deinterleave/float/channels:" + std::to_string(channels), iterations / 8, iterations, (double)length * channels, [&]() {
+            Convert_Deinterleave(interleaved.data(), 0, channels, length, pointers.data());
+        });
+        measure("Convert_Deinterleave/int16/channels:" + std::to_string(channels), iterations / 8, iterations, (double)length * channels, [&]() {
+            Convert_Deinterleave(interleaved16.data(), 1, channels, length, pointers.data());
+        });
+        measure("Convert_Interleave/channels:" + std::to_string(channels), iterations / 8, iterations, (double)length * channels, [&]() {
+            Convert_Interleave(pointers.data(), channels, length, interleaved.data());
+        });
+    }
+}
+
+void writeJson(FILE* file, bool quick) {
+    fprintf(file, "{\n  \"context\": {\"sample_rate\": %g, \"quick\": %s},\n  \"benchmarks\": [\n", sampleRate, quick ? "true" : "false");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %zu, \"samples_per_second\": %.1f, \"p50_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f}%s\n",
+            r.name.c_str(), r.iterations, r.samplesPerSecond, r.p50, r.p99, r.max, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    const char* outPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--quick")) {
+            quick = true;
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--out results.json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    benchStretch(quick ? 0.5 : 5.0);
+    benchFFT(quick ? 1000 : 20000);
+    benchSTFT(quick ? 200 : 2000);
+    benchConvert(quick ? 1000 : 20000);
+
+    FILE* file = outPath ? fopen(outPath, "w") : stdout;
+    if (!file) {
+        fprintf(stderr, "could not open %s\n", outPath);
+        return 1;
+    }
+    writeJson(file, quick);
+    if (outPath) fclose(file);
+    return 0;
+}
@@ -0,0 +1,757 @@
+// Behavioural checks for the C ABI exported by this library. Run through CTest, or directly:
+//
+//     stretch_check
+//
+// Each check prints one line, and the exit code is non-zero if any failed. The global allocation operators are
+// replaced below, so on platforms where the library's allocations resolve to them (ELF and Mach-O shared libraries)
+// the checks also see memory the stretcher allocates internally, not only the binding's own hooks.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+struct Stretch;
+struct StretchInstancePool;
+struct BaseSTFT;
+struct STFTScheduler;
+
+struct STFTScheduleReport {
+    int stepsPerHop;
+    int expectedSteps;
+    int stepsRun;
+    int maxStepsRun;
+    int hopsCompleted;
+    float microseconds;
+    float maxMicroseconds;
+};
+
+extern "C" {
+    typedef void* (*StretchAllocFunction)(void* userData, size_t bytes);
+    typedef void (*StretchFreeFunction)(void* userData, void* pointer);
+    typedef int (*StretchReadFunction)(void* userData, float* interleaved, int frames);
+    typedef void (*STFTSpectralCallback)(void* userData, float** spectra, int channels, int bands);
+
+    Stretch* Stretch_CreateSeed(long seed);
+    void Stretch_Release(Stretch* stretch);
+    void Stretch_PresetDefault(Stretch* stretch, int nChannels, float sampleRate, bool splitComputation);
+    void Stretch_Process(Stretch* stretch, float* input, int pcmLength, float* output, int pcmOutLength);
+    void Stretch_ProcessFormat(Stretch* stretch, const void* input, int format, int pcmLength, float* output, int pcmOutLength);
+    void Stretch_SetAllocator(StretchAllocFunction alloc, StretchFreeFunction free, void* userData);
+    size_t Stretch_AllocationsSinceConfigure(Stretch* stretch);
+    size_t Stretch_MemoryFootprint(Stretch* stretch);
+    void Stretch_EnableQualityTiers(Stretch* stretch);
+    void Stretch_SetQualityTier(Stretch* stretch, int tier);
+    int Stretch_GetQualityTier(Stretch* stretch);
+    StretchInstancePool* StretchInstancePool_Create(int count, int nChannels, float sampleRate, int preset, bool splitComputation, long long seed);
+    void StretchInstancePool_Release(StretchInstancePool* pool);
+    int StretchInstancePool_Available(StretchInstancePool* pool);
+    Stretch* StretchInstancePool_Rent(StretchInstancePool* pool);
+    bool StretchInstancePool_Return(StretchInstancePool* pool, Stretch* stretch);
+    void Stretch_RenderStart(Stretch* stretch, StretchReadFunction read, void* userData);
+    void Stretch_SetRenderRate(Stretch* stretch, double rate);
+    void Stretch_SetRenderTimeMap(Stretch* stretch, const double* outputFrames, const double* inputFrames, int points, double rateAfter);
+    int Stretch_Render(Stretch* stretch, float* output, int frames);
+    double Stretch_RenderInputPosition(Stretch* stretch);
+    long long Stretch_RenderFile(Stretch* stretch, const char* inputPath, int inputFormat, const char* outputPath, double playbackRate);
+    int Stretch_BlockSamples(Stretch* stretch);
+    bool Stretch_SetFreqMapTable(Stretch* stretch, const float* inputFreqs, const float* outputFreqs, int points, int interpolation);
+    void Stretch_SetPipelined(Stretch* stretch, int maxBlockSamples);
+    int Stretch_PipelineUnderruns(Stretch* stretch);
+    void Stretch_OutputSeek(Stretch* stretch, float* input, int inputLength);
+    int Stretch_OutputSeekLength(Stretch* stretch, float playbackRate);
+    long long Stretch_RenderOfflineLength(long long inputFrames, double playbackRate);
+    void Stretch_RenderOffline(const float* input, long long inputFrames, int channels, float sampleRate, double playbackRate, int threads, float* output, long long seed);
+
+    void Convert_Deinterleave(const void* interleaved, int format, int channels, size_t length, float* const* planar);
+    void Convert_Interleave(const float* const* planar, int channels, size_t length, float* interleaved);
+
+    BaseSTFT* STFT_Create(bool splitComputation);
+    void STFT_Delete(BaseSTFT* stftBase);
+    void STFT_Configure(BaseSTFT* stftBase, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry);
+    STFTScheduler* STFTScheduler_Create(BaseSTFT* stftBase);
+    void STFTScheduler_Delete(STFTScheduler* scheduler);
+    bool STFTScheduler_Configure(STFTScheduler* scheduler, size_t intervalSamples, size_t callbackSamples);
+    void STFTScheduler_Process(STFTScheduler* scheduler, const float* input, float* output, size_t length, STFTSpectralCallback callback, void* userData);
+    size_t STFTScheduler_Latency(STFTScheduler* scheduler);
+    void STFTScheduler_Report(STFTScheduler* scheduler, STFTScheduleReport* report);
+}
+
+// Heap use through the global operators, counted only while `counting` is set on the calling thread
+namespace {
+    thread_local bool counting = false;
+    std::atomic<size_t> heapAllocations(0), heapBytes(0);
+
+    void* countedAllocate(size_t bytes) {
+        if (counting) {
+            heapAllocations.fetch_add(1, std::memory_order_relaxed);
+            heapBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        void* pointer = std::malloc(bytes ? bytes : 1);
+        if (!pointer) throw std::bad_alloc();
+        return pointer;
+    }
+}
+
+void* operator new(size_t bytes) {
+    return countedAllocate(bytes);
+}
+
+void* operator new[](size_t bytes) {
+    return countedAllocate(bytes);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+const float sampleRate = 48000;
+const double pi = 3.14159265358979323846;
+
+int failures = 0;
+
+void report(const char* name, bool passed, const char* detail) {
+    fprintf(stderr, "%-40s %s  %s\n", name, passed ? "ok    " : "FAILED", detail);
+    if (!passed) ++failures;
+}
+
+void fillNoise(std::vector<float>& buffer, unsigned state) {
+    for (float& sample : buffer) {
+        state = state * 1664525u + 1013904223u;
+        sample = (float)(state >> 8) / (float)(1 << 24) * 2 - 1;
+    }
+}
+
+void fillSine(std::vector<float>& buffer, int channels, double frequency, float amplitude) {
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = amplitude * (float)std::sin(2 * pi * frequency * (double)(i / channels) / sampleRate);
+    }
+}
+
+// Frequency of a clean tone from its upward zero crossings, interpolated between samples
+double measureFrequency(const float* samples, size_t length) {
+    double first = -1, last = -1;
+    int crossings = 0;
+    for (size_t i = 1; i < length; ++i) {
+        if (samples[i - 1] < 0 && samples[i] >= 0) {
+            double at = (double)(i - 1) + samples[i - 1] / (samples[i - 1] - samples[i]);
+            if (first < 0) first = at;
+            last = at;
+            ++crossings;
+        }
+    }
+    return crossings > 1 ? (crossings - 1) * sampleRate / (last - first) : 0;
+}
+
+// A pipelined instance gives the same output as a plain one, one pipeline block later. Blocks are paced in real
+// time so the helper keeps up; a run with underruns (whose output is silence) is retried with more slack.
+void checkPipeline() {
+    const int channels = 2, block = 256, blocks = (int)sampleRate / block;
+    std::vector<float> input((size_t)block * channels * blocks);
+    fillNoise(input, 5);
+    std::vector<float> plain(input.size()), pipelined(input.size());
+
+    Stretch* reference = Stretch_CreateSeed(2);
+    Stretch_PresetDefault(reference, channels, sampleRate, true);
+    for (int b = 0; b < blocks; ++b) {
+        size_t offset = (size_t)b * block * channels;
+        Stretch_Process(reference, input.data() + offset, block, plain.data() + offset, block);
+    }
+    Stretch_Release(reference);
+
+    int underruns = -1;
+    double worst = 0;
+    auto blockTime = std::chrono::microseconds((long long)(block * 1e6 / sampleRate));
+    for (int attempt = 0; attempt < 3 && underruns != 0; ++attempt) {
+        Stretch* stretch = Stretch_CreateSeed(2);
+        Stretch_PresetDefault(stretch, channels, sampleRate, true);
+        Stretch_SetPipelined(stretch, block);
+        for (int b = 0; b < blocks; ++b) {
+            size_t offset = (size_t)b * block * channels;
+            Stretch_Process(stretch, input.data() + offset, block, pipelined.data() + offset, block);
+            std::this_thread::sleep_for(blockTime * (attempt + 1));
+        }
+        underruns = Stretch_PipelineUnderruns(stretch);
+        Stretch_SetPipelined(stretch, 0);
+        Stretch_Release(stretch);
+
+        worst = 0;
+        for (size_t i = 0; i + (size_t)block * channels < plain.size(); ++i) {
+            worst = std::max(worst, (double)std::fabs(pipelined[i + (size_t)block * channels] - plain[i]));
+        }
+    }
+
+    char detail[160];
+    snprintf(detail, sizeof(detail), "largest difference %.2e one %d-frame block later, %d underruns", worst, block, underruns);
+    report("pipelined output matches plain", underruns == 0 && worst < 1e-6, detail);
+}
+
+// With one segment, Stretch_RenderOffline is the streaming path run in one call: seek, then process
+void checkOfflineMatchesStreaming() {
+    const int channels = 2, block = 512;
+    const double playbackRate = 0.75; // block * playbackRate is whole, so every block has the same ratio
+    const long long seed = 7;
+    long long inputFrames = (long long)sampleRate * 2;
+    std::vector<float> input((size_t)inputFrames * channels);
+    fillNoise(input, 21);
+    long long outputFrames = Stretch_RenderOfflineLength(inputFrames, playbackRate);
+    std::vector<float> offline((size_t)outputFrames * channels);
+    Stretch_RenderOffline(input.data(), inputFrames, channels, sampleRate, playbackRate, 0, offline.data(), seed);
+
+    Stretch* stretch = Stretch_CreateSeed(seed);
+    Stretch_PresetDefault(stretch, channels, sampleRate, false);
+    int seekLength = Stretch_OutputSeekLength(stretch, (float)playbackRate);
+    std::vector<float> padded(((size_t)inputFrames + seekLength + block * 2) * channels, 0.0f);
+    std::copy(input.begin(), input.end(), padded.begin());
+    Stretch_OutputSeek(stretch, padded.data(), seekLength);
+
+    std::vector<float> streaming((size_t)outputFrames * channels);
+    long long inputDone = 0;
+    for (long long outputDone = 0; outputDone < outputFrames;) {
+        int length = (int)std::min((long long)block, outputFrames - outputDone);
+        long long inputEnd = (long long)std::floor((outputDone + length) * playbackRate + 0.5);
+        Stretch_Process(stretch, padded.data() + (size_t)(seekLength + inputDone) * channels, (int)(inputEnd - inputDone), streaming.data() + (size_t)outputDone * channels, length);
+        inputDone = inputEnd;
+        outputDone += length;
+    }
+    Stretch_Release(stretch);
+
+    double error = 0, energy = 0;
+    for (size_t i = 0; i < offline.size(); ++i) {
+        double difference = offline[i] - streaming[i];
+        error += difference * difference;
+        energy += (double)offline[i] * offline[i];
+    }
+    double relative = energy > 0 ? std::sqrt(error / energy) : 1;
+    char detail[160];
+    snprintf(detail, sizeof(detail), "relative RMS difference %.2e over %lld frames", relative, outputFrames);
+    report("offline render matches streaming", energy > 0 && relative < 1e-3, detail);
+}
+
+// The scheduler never runs more than its expected share of a hop in one callback, and with nothing done to the
+// spectrum it reconstructs the input after the latency it reports
+void checkScheduler() {
+    const int block = 1024, interval = 256, callback = 64;
+    bool passed = true;
+    char detail[160] = "";
+    for (int split = 0; split < 2; ++split) {
+        BaseSTFT* stft = STFT_Create(split != 0);
+        STFT_Configure(stft, 1, 1, block, interval, interval, 0);
+        STFTScheduler* scheduler = STFTScheduler_Create(stft);
+        bool configured = STFTScheduler_Configure(scheduler, interval, callback);
+
+        std::vector<float> input((size_t)sampleRate * 2), output(input.size());
+        fillNoise(input, 17);
+        int hops = 0;
+        for (size_t i = 0; i < input.size(); i += callback) {
+            STFTScheduler_Process(scheduler, input.data() + i, output.data() + i, callback, nullptr, nullptr);
+            STFTScheduleReport report;
+            STFTScheduler_Report(scheduler, &report);
+            hops += report.hopsCompleted;
+        }
+        STFTScheduleReport report;
+        STFTScheduler_Report(scheduler, &report);
+        size_t latency = STFTScheduler_Latency(scheduler);
+        STFTScheduler_Delete(scheduler);
+        STFT_Delete(stft);
+
+        double error = 0, energy = 0;
+        for (size_t i = latency + block; i < input.size(); ++i) {
+            double difference = output[i] - input[i - latency];
+            error += difference * difference;
+            energy += (double)input[i - latency] * input[i - latency];
+        }
+        double relative = energy > 0 ? std::sqrt(error / energy) : 1;
+        passed = passed && configured && report.maxStepsRun <= report.expectedSteps && hops == (int)(input.size() / interval) && relative < 1e-3;
+        snprintf(detail + strlen(detail), sizeof(detail) - strlen(detail), "%s%s: %d/%d steps per call, error %.1e", split ? ", " : "", split ? "split" : "plain", report.maxStepsRun, report.stepsPerHop, relative);
+    }
+    report("STFT scheduler spreads hops", passed, detail);
+}
+
+// Invalid tables are rejected, and a valid one moves a tone where the table says
+void checkFreqMap() {
+    Stretch* stretch = Stretch_CreateSeed(1);
+    Stretch_PresetDefault(stretch, 1, sampleRate, false);
+
+    const float in[] = {100, 1000, 20000};
+    const float duplicate[] = {100, 100, 20000};
+    const float unsorted[] = {1000, 100, 20000};
+    const float zero[] = {0, 1000, 20000};
+    const float out[] = {200, 2000, 40000};
+    const float negative[] = {200, -1, 40000};
+    const float notANumber[] = {200, std::nanf(""), 40000};
+    bool rejected = !Stretch_SetFreqMapTable(stretch, duplicate, out, 3, 0)
+        && !Stretch_SetFreqMapTable(stretch, unsorted, out, 3, 0)
+        && !Stretch_SetFreqMapTable(stretch, zero, out, 3, 0)
+        && !Stretch_SetFreqMapTable(stretch, in, negative, 3, 0)
+        && !Stretch_SetFreqMapTable(stretch, in, notANumber, 3, 0)
+        && !Stretch_SetFreqMapTable(stretch, in, out, 1, 0)
+        && !Stretch_SetFreqMapTable(stretch, in, out, 3, 2);
+    report("freq map rejects invalid tables", rejected, "duplicate, unsorted, zero, negative, NaN, one point, bad interpolation");
+
+    const double frequency = 440;
+    bool passed = true;
+    char detail[160] = "";
+    for (int interpolation = 0; interpolation < 2; ++interpolation) {
+        bool accepted = Stretch_SetFreqMapTable(stretch, in, out, 3, interpolation);
+        std::vector<float> input((size_t)sampleRate * 2), output(input.size());
+        fillSine(input, 1, frequency, 0.5f);
+        Stretch_Process(stretch, input.data(), (int)input.size(), output.data(), (int)output.size());
+        size_t steady = (size_t)sampleRate / 2;
+        double measured = measureFrequency(output.data() + steady, output.size() - steady);
+        passed = passed && accepted && std::fabs(measured / (2 * frequency) - 1) < 0.02;
+        snprintf(detail + strlen(detail), sizeof(detail) - strlen(detail), "%s%s: %.1f Hz", interpolation ? ", " : "", interpolation ? "cubic" : "linear", measured);
+    }
+    Stretch_Release(stretch);
+    report("freq map doubles a 440 Hz tone", passed, detail);
+}
+
+// Renting hands out each instance once until it comes back, and returns are refused twice or from elsewhere
+void checkInstancePool() {
+    const int count = 3;
+    StretchInstancePool* pool = StretchInstancePool_Create(count, 2, sampleRate, 0, false, 1);
+    std::vector<Stretch*> rented;
+    for (int i = 0; i < count; ++i) rented.push_back(StretchInstancePool_Rent(pool));
+    bool distinct = std::find(rented.begin(), rented.end(), nullptr) == rented.end();
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < i; ++j) distinct = distinct && rented[i] != rented[j];
+    }
+    bool exhausted = StretchInstancePool_Rent(pool) == nullptr && StretchInstancePool_Available(pool) == 0;
+
+    // a rented instance still works, and comes back out of the pool after its return
+    std::vector<float> block(512 * 2, 0.25f), output(block.size());
+    Stretch_Process(rented[1], block.data(), 512, output.data(), 512);
+    bool returned = StretchInstancePool_Return(pool, rented[1]);
+    bool doubleRefused = !StretchInstancePool_Return(pool, rented[1]) && StretchInstancePool_Available(pool) == 1;
+    Stretch* other = Stretch_CreateSeed(1);
+    bool foreignRefused = !StretchInstancePool_Return(pool, other);
+    Stretch_Release(other);
+    Stretch* again = StretchInstancePool_Rent(pool);
+    bool reused = again == rented[1] && StretchInstancePool_Rent(pool) == nullptr;
+
+    for (Stretch* stretch : rented) StretchInstancePool_Return(pool, stretch);
+    bool refilled = StretchInstancePool_Available(pool) == count;
+    StretchInstancePool_Release(pool);
+
+    bool passed = distinct && exhausted && returned && doubleRefused && foreignRefused && reused && refilled;
+    char detail[160];
+    snprintf(detail, sizeof(detail), "distinct %d, exhausted %d, double return %s, foreign %s, reused %d, refilled %d", distinct, exhausted, doubleRefused ? "refused" : "accepted", foreignRefused ? "refused" : "accepted", reused, refilled);
+    report("instance pool rent and return", passed, detail);
+}
+
+// Every layout and sample format survives deinterleaving and interleaving again
+void checkConversion() {
+    const int channelCounts[] = {1, 2, 3, 4, 6, 8};
+    const size_t lengths[] = {0, 1, 7, 64, 1001};
+    bool passed = true;
+    for (int channels : channelCounts) {
+        for (size_t length : lengths) {
+            std::vector<float> interleaved(length * channels), roundTrip(length * channels);
+            fillNoise(interleaved, (unsigned)(channels * 1000 + length));
+            std::vector<float> planar(length * channels);
+            std::vector<float*> planarChannels(channels);
+            for (int c = 0; c < channels; ++c) planarChannels[c] = planar.data() + c * length;
+
+            Convert_Deinterleave(interleaved.data(), 0, channels, length, planarChannels.data());
+            Convert_Interleave(planarChannels.data(), channels, length, roundTrip.data());
+            passed = passed && roundTrip == interleaved;
+
+            std::vector<int16_t> int16(length * channels);
+            std::vector<int32_t> int32(length * channels);
+            std::vector<unsigned char> int24(length * channels * 3);
+            for (size_t i = 0; i < int16.size(); ++i) {
+                int32_t value = (int32_t)(interleaved[i] * 8388607);
+                int16[i] = (int16_t)(value >> 8);
+                int32[i] = value * 256;
+                for (int b = 0; b < 3; ++b) int24[i * 3 + b] = (unsigned char)((uint32_t)value >> (8 * b));
+            }
+            Convert_Deinterleave(int16.data(), 1, channels, length, planarChannels.data());
+            for (size_t i = 0; i < length; ++i) {
+                for (int c = 0; c < channels; ++c) passed = passed && planar[c * length + i] == int16[i * channels + c] / 32768.0f;
+            }
+            Convert_Deinterleave(int24.data(), 2, channels, length, planarChannels.data());
+            for (size_t i = 0; i < length; ++i) {
+                for (int c = 0; c < channels; ++c) passed = passed && planar[c * length + i] == (float)(int32[i * channels + c] / 256) / 8388608.0f;
+            }
+            Convert_Deinterleave(int32.data(), 3, channels, length, planarChannels.data());
+            for (size_t i = 0; i < length; ++i) {
+                for (int c = 0; c < channels; ++c) passed = passed && planar[c * length + i] == (float)int32[i * channels + c] / 2147483648.0f;
+            }
+        }
+    }
+    report("conversion round trips", passed, "float, int16, int24 and int32 at 1-8 channels");
+
+    // Stretch_ProcessFormat gives the same output as converting first and calling Stretch_Process
+    const int channels = 2, block = 512, blocks = 40;
+    std::vector<int16_t> pcm((size_t)block * channels * blocks);
+    std::vector<float> noise(pcm.size()), converted(pcm.size());
+    fillNoise(noise, 7);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = (int16_t)(noise[i] * 32767);
+        converted[i] = pcm[i] / 32768.0f;
+    }
+    Stretch* direct = Stretch_CreateSeed(3);
+    Stretch* viaFormat = Stretch_CreateSeed(3);
+    Stretch_PresetDefault(direct, channels, sampleRate, false);
+    Stretch_PresetDefault(viaFormat, channels, sampleRate, false);
+    std::vector<float> outputDirect((size_t)block * channels), outputFormat((size_t)block * channels);
+    bool same = true;
+    for (int b = 0; b < blocks; ++b) {
+        size_t offset = (size_t)b * block * channels;
+        Stretch_Process(direct, converted.data() + offset, block, outputDirect.data(), block);
+        Stretch_ProcessFormat(viaFormat, pcm.data() + offset, 1, block, outputFormat.data(), block);
+        same = same && outputDirect == outputFormat;
+    }
+    Stretch_Release(direct);
+    Stretch_Release(viaFormat);
+    report("int16 process matches float", same, "Stretch_ProcessFormat against Stretch_Process");
+}
+
+std::atomic<size_t> hookAllocations(0);
+
+void* hookAllocate(void*, size_t bytes) {
+    hookAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(bytes);
+}
+
+void hookFree(void*, void* pointer) {
+    std::free(pointer);
+}
+
+// Nothing allocates once an instance is configured, including tier switches and calls longer than a block
+void checkAllocations() {
+    const int channels = 2, block = 512;
+    Stretch_SetAllocator(hookAllocate, hookFree, nullptr);
+    counting = true;
+    heapBytes = 0;
+    Stretch* stretch = Stretch_CreateSeed(1);
+    Stretch_PresetDefault(stretch, channels, sampleRate, false);
+    Stretch_EnableQualityTiers(stretch);
+    counting = false;
+    size_t libraryBytes = heapBytes.load();
+
+    std::vector<float> input((size_t)block * 8 * channels), output(input.size());
+    fillNoise(input, 11);
+    std::vector<int16_t> pcm(input.size());
+    for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = (int16_t)(input[i] * 32767);
+
+    size_t hooksBefore = hookAllocations.load();
+    heapAllocations = 0;
+    counting = true;
+    for (int i = 0; i < 400; ++i) {
+        if (i % 50 == 0) Stretch_SetQualityTier(stretch, (i / 50) % 3);
+        int length = (i % 7 == 0) ? block * 6 + 5 : block;
+        if (i % 5 == 0) {
+            Stretch_ProcessFormat(stretch, pcm.data(), 1, length, output.data(), length);
+        } else {
+            Stretch_Process(stretch, input.data(), length, output.data(), length);
+        }
+    }
+    counting = false;
+    size_t hooks = hookAllocations.load() - hooksBefore;
+    size_t heap = heapAllocations.load();
+    size_t perInstance = Stretch_AllocationsSinceConfigure(stretch);
+    size_t footprint = Stretch_MemoryFootprint(stretch);
+    Stretch_Release(stretch);
+    Stretch_SetAllocator(nullptr, nullptr, nullptr);
+
+    char detail[160];
+    snprintf(detail, sizeof(detail), "hooks %zu, instance %zu, global new %zu", hooks, perInstance, heap);
+    report("no allocations while processing", hooks == 0 && perInstance == 0 && heap == 0, detail);
+    // Not a pass/fail: how much of an instance's memory Stretch_MemoryFootprint can't see
+    snprintf(detail, sizeof(detail), "%zu bytes through global new, footprint reports %zu", libraryBytes, footprint);
+    report("library memory per instance (info)", true, detail);
+}
+
+struct RenderSource {
+    int channels;
+    long long position;
+};
+
+int readRenderSource(void* userData, float* interleaved, int frames) {
+    RenderSource* source = static_cast<RenderSource*>(userData);
+    for (int i = 0; i < frames * source->channels; ++i) interleaved[i] = (float)std::sin(0.01 * (double)(source->position * source->channels + i));
+    source->position += frames;
+    return frames;
+}
+
+// Stretch_Render pulls exactly floor(map(output position)) input frames through a time map with breakpoints, a
+// jump and a rate above block / interval, without allocating while rendering
+void checkRenderTimeMap() {
+    const int channels = 2, block = 441;
+    Stretch* stretch = Stretch_CreateSeed(1);
+    Stretch_PresetDefault(stretch, channels, sampleRate, false);
+    RenderSource source = {channels, 0};
+    Stretch_RenderStart(stretch, readRenderSource, &source);
+    std::vector<float> output((size_t)block * channels);
+
+    bool counted = true;
+    size_t allocations = 0;
+    long long pulled = 0, outputDone = 0;
+    auto render = [&](int blocks) {
+        size_t before = Stretch_AllocationsSinceConfigure(stretch);
+        for (int b = 0; b < blocks; ++b) {
+            pulled += Stretch_Render(stretch, output.data(), block);
+            outputDone += block;
+        }
+        allocations += Stretch_AllocationsSinceConfigure(stretch) - before;
+    };
+    auto expect = [&](double position) {
+        counted = counted && pulled == (long long)std::floor(position) && source.position == pulled && std::fabs(Stretch_RenderInputPosition(stretch) - position) < 1e-6;
+    };
+
+    Stretch_SetRenderRate(stretch, 1.37);
+    render(100);
+    expect(outputDone * 1.37);
+
+    // slow down, jump ahead by a second, then run at 12x (well above block / interval)
+    double base = Stretch_RenderInputPosition(stretch);
+    const double outputFrames[] = {(double)outputDone, (double)outputDone + 1000, (double)outputDone + 1001};
+    const double inputFrames[] = {base, base + 500, base + 500 + sampleRate};
+    Stretch_SetRenderTimeMap(stretch, outputFrames, inputFrames, 3, 12);
+    long long mapStart = outputDone;
+    render(100);
+    expect(inputFrames[2] + (double)(outputDone - mapStart - 1001) * 12);
+    Stretch_Release(stretch);
+
+    char detail[160];
+    snprintf(detail, sizeof(detail), "%lld input frames for %lld output, %zu allocations while rendering", pulled, outputDone, allocations);
+    report("render follows the time map", counted && allocations == 0, detail);
+}
+
+void putLittleEndian(std::vector<unsigned char>& bytes, uint32_t value, int size) {
+    for (int b = 0; b < size; ++b) bytes.push_back((unsigned char)(value >> (8 * b)));
+}
+
+// Stretch_RenderFile writes the same samples as seeking and streaming the file's contents block by block, in a float
+// WAV with a correct header, and refuses files that don't match the instance
+void checkRenderFile() {
+    const int channels = 2;
+    const double playbackRate = 0.8; // below 1, so each block's input fits the scratch and streaming isn't split into pieces
+    const long long inputFrames = (long long)sampleRate + 123;
+    const char* inputPath = "stretch_check_input.wav";
+    const char* outputPath = "stretch_check_output.wav";
+
+    std::vector<float> noise((size_t)inputFrames * channels);
+    fillNoise(noise, 31);
+    std::vector<int16_t> pcm(noise.size());
+    std::vector<unsigned char> wav;
+    uint32_t dataBytes = (uint32_t)(pcm.size() * 2);
+    wav.insert(wav.end(), {'R', 'I', 'F', 'F'});
+    putLittleEndian(wav, 36 + dataBytes, 4);
+    wav.insert(wav.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    putLittleEndian(wav, 16, 4);
+    putLittleEndian(wav, 1, 2); // PCM
+    putLittleEndian(wav, channels, 2);
+    putLittleEndian(wav, (uint32_t)sampleRate, 4);
+    putLittleEndian(wav, (uint32_t)sampleRate * channels * 2, 4);
+    putLittleEndian(wav, channels * 2, 2);
+    putLittleEndian(wav, 16, 2);
+    wav.insert(wav.end(), {'d', 'a', 't', 'a'});
+    putLittleEndian(wav, dataBytes, 4);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = (int16_t)(noise[i] * 32767);
+        putLittleEndian(wav, (uint16_t)pcm[i], 2);
+    }
+    FILE* file = fopen(inputPath, "wb");
+    bool written = file && fwrite(wav.data(), 1, wav.size(), file) == wav.size();
+    if (file) fclose(file);
+
+    Stretch* stretch = Stretch_CreateSeed(9);
+    Stretch_PresetDefault(stretch, channels, sampleRate, false);
+    long long outputFrames = Stretch_RenderFile(stretch, inputPath, 0, outputPath, playbackRate);
+    Stretch_Release(stretch);
+
+    std::vector<unsigned char> rendered;
+    file = fopen(outputPath, "rb");
+    if (file) {
+        unsigned char buffer[65536];
+        size_t got;
+        while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) rendered.insert(rendered.end(), buffer, buffer + got);
+        fclose(file);
+    }
+    auto readLittleEndian = [&](size_t offset, int size) {
+        uint32_t value = 0;
+        for (int b = 0; b < size; ++b) value |= (uint32_t)rendered[offset + b] << (8 * b);
+        return value;
+    };
+    bool header = rendered.size() == 44 + (size_t)outputFrames * channels * sizeof(float) && outputFrames > 0
+        && std::memcmp(rendered.data(), "RIFF", 4) == 0 && std::memcmp(rendered.data() + 8, "WAVE", 4) == 0
+        && readLittleEndian(20, 2) == 3 && readLittleEndian(22, 2) == channels && readLittleEndian(24, 4) == (uint32_t)sampleRate
+        && readLittleEndian(40, 4) == (uint32_t)outputFrames * channels * sizeof(float);
+
+    // The same render by hand: pre-roll, then one stretcher block of output at a time
+    double worst = header ? 0 : 1;
+    if (header) {
+        Stretch* streaming = Stretch_CreateSeed(9);
+        Stretch_PresetDefault(streaming, channels, sampleRate, false);
+        int block = Stretch_BlockSamples(streaming);
+        int seekLength = Stretch_OutputSeekLength(streaming, (float)playbackRate);
+        std::vector<float> padded(((size_t)seekLength + inputFrames + block * 2) * channels, 0.0f);
+        for (size_t i = 0; i < pcm.size(); ++i) padded[i] = pcm[i] / 32768.0f;
+        Stretch_OutputSeek(streaming, padded.data(), seekLength);
+        std::vector<float> expected((size_t)outputFrames * channels);
+        long long inputDone = 0;
+        for (long long outputDone = 0; outputDone < outputFrames;) {
+            int length = (int)std::min((long long)block, outputFrames - outputDone);
+            long long inputEnd = (long long)std::floor((outputDone + length) * playbackRate + 0.5);
+            Stretch_Process(streaming, padded.data() + (size_t)(seekLength + inputDone) * channels, (int)(inputEnd - inputDone), expected.data() + (size_t)outputDone * channels, length);
+            inputDone = inputEnd;
+            outputDone += length;
+        }
+        Stretch_Release(streaming);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            float sample;
+            std::memcpy(&sample, rendered.data() + 44 + i * sizeof(float), sizeof(float));
+            worst = std::max(worst, (double)std::fabs(sample - expected[i]));
+        }
+    }
+
+    Stretch* mono = Stretch_CreateSeed(9);
+    Stretch_PresetDefault(mono, 1, sampleRate, false);
+    bool refused = Stretch_RenderFile(mono, inputPath, 0, outputPath, playbackRate) == -1
+        && Stretch_RenderFile(mono, "stretch_check_missing.wav", 0, outputPath, playbackRate) == -1;
+    Stretch_Release(mono);
+    std::remove(inputPath);
+    std::remove(outputPath);
+
+    char detail[160];
+    snprintf(detail, sizeof(detail), "%lld frames, header %s, largest difference %.2e", outputFrames, header ? "ok" : "wrong", worst);
+    report("render file matches streaming", written && header && worst < 1e-6 && refused, detail);
+}
+
+// Switching tiers back and forth leaves a steady tone without clicks or dropouts
+void checkQualitySwitch() {
+    const int block = 256;
+    const double frequency = 440;
+    const float amplitude = 0.5f;
+    Stretch* stretch = Stretch_CreateSeed(1);
+    Stretch_PresetDefault(stretch, 1, sampleRate, false);
+    Stretch_EnableQualityTiers(stretch);
+
+    std::vector<float> input(block), output;
+    std::vector<float> blockOutput(block);
+    size_t position = 0;
+    auto run = [&](int blocks) {
+        for (int b = 0; b < blocks; ++b) {
+            for (int i = 0; i < block; ++i) {
+                input[i] = amplitude * (float)std::sin(2 * pi * frequency * (double)(position + i) / sampleRate);
+            }
+            position += block;
+            Stretch_Process(stretch, input.data(), block, blockOutput.data(), block);
+            output.insert(output.end(), blockOutput.begin(), blockOutput.end());
+        }
+    };
+
+    int settle = (int)(sampleRate / block);
+    run(2 * settle);
+    size_t switchStart = output.size();
+    bool switched = true;
+    const int tiers[] = {2, 0, 1, 0};
+    for (int tier : tiers) {
+        Stretch_SetQualityTier(stretch, tier);
+        int blocks = 0;
+        while (Stretch_GetQualityTier(stretch) != tier && blocks < 16) {
+            run(1);
+            ++blocks;
+        }
+        switched = switched && Stretch_GetQualityTier(stretch) == tier;
+        run(settle / 2);
+    }
+    Stretch_Release(stretch);
+
+    // The second before the first switch sets the reference slope and level
+    double steadySlope = 0, steadyEnergy = 0;
+    for (size_t i = switchStart - (size_t)sampleRate; i < switchStart; ++i) {
+        steadySlope = std::max(steadySlope, (double)std::fabs(output[i] - output[i - 1]));
+        steadyEnergy += output[i] * output[i];
+    }
+    double steadyRms = std::sqrt(steadyEnergy / sampleRate);
+    double worstSlope = 0, lowestRatio = 1e9, highestRatio = 0;
+    const size_t window = 1024;
+    for (size_t start = switchStart; start + window <= output.size(); start += window / 2) {
+        double energy = 0;
+        for (size_t i = start; i < start + window; ++i) {
+            worstSlope = std::max(worstSlope, (double)std::fabs(output[i] - output[i - 1]));
+            energy += output[i] * output[i];
+        }
+        double ratio = std::sqrt(energy / window) / steadyRms;
+        lowestRatio = std::min(lowestRatio, ratio);
+        highestRatio = std::max(highestRatio, ratio);
+    }
+
+    bool passed = switched && steadyRms > amplitude * 0.5 && worstSlope <= steadySlope * 1.5 + 1e-3 && lowestRatio > 0.7 && highestRatio < 1.3;
+    char detail[160];
+    snprintf(detail, sizeof(detail), "slope %.4f (steady %.4f), level %.2f-%.2f of steady", worstSlope, steadySlope, lowestRatio, highestRatio);
+    report("glitch-free quality switch", passed, detail);
+}
+
+// Every tier has tier 0's latency, so clicks come out at the same delay before, during and after switches, with
+// and without split computation (where lower tiers shorten their block to make up for the longer interval)
+void checkQualityAlignment() {
+    const int block = 256, period = 4801, blocks = (int)(sampleRate * 8) / block;
+    const int tiers[] = {2, 0, 1, 0};
+    bool passed = true;
+    char detail[160] = "";
+    for (int split = 0; split < 2; ++split) {
+        Stretch* stretch = Stretch_CreateSeed(1);
+        Stretch_PresetDefault(stretch, 1, sampleRate, split != 0);
+        Stretch_EnableQualityTiers(stretch);
+        std::vector<float> input((size_t)blocks * block, 0.0f), output(input.size());
+        for (size_t i = period / 2; i < input.size(); i += period) input[i] = 1;
+
+        int switchBlock = (int)sampleRate / block * 2, used = 0;
+        for (int b = 0; b < blocks; ++b) {
+            int step = (b - switchBlock) / (blocks / 6);
+            if (b >= switchBlock && (b - switchBlock) % (blocks / 6) == 0 && step < 4) Stretch_SetQualityTier(stretch, tiers[step]);
+            Stretch_Process(stretch, input.data() + (size_t)b * block, block, output.data() + (size_t)b * block, block);
+            used |= 1 << Stretch_GetQualityTier(stretch);
+        }
+        Stretch_Release(stretch);
+
+        // Delay of each click's loudest output sample, compared with the clicks before the first switch
+        int reference = -1, worst = 0;
+        for (size_t click = period / 2 + period; click + period <= output.size(); click += period) {
+            size_t peak = click;
+            for (size_t i = click; i < click + period; ++i) {
+                if (std::fabs(output[i]) > std::fabs(output[peak])) peak = i;
+            }
+            int delay = (int)(peak - click);
+            if (reference < 0) reference = delay;
+            worst = std::max(worst, std::abs(delay - reference));
+        }
+        passed = passed && worst <= 32;
+        snprintf(detail + strlen(detail), sizeof(detail) - strlen(detail), "%s%s: %d samples off (tiers used %s%s%s)", split ? ", " : "", split ? "split" : "plain", worst, used & 1 ? "0" : "", used & 2 ? "1" : "", used & 4 ? "2" : "");
+    }
+    report("quality switch keeps alignment", passed, detail);
+}
+
+} // namespace
+
+int main() {
+    checkPipeline();
+    checkOfflineMatchesStreaming();
+    checkScheduler();
+    checkFreqMap();
+    checkInstancePool();
+    checkAllocations();
+    checkConversion();
+    checkRenderTimeMap();
+    checkRenderFile();
+    checkQualitySwitch();
+    checkQualityAlignment();
+    if (failures) fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,430 @@
+#include <cstdint>
+#include <cstring>
+#include "./convert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CONVERT_SSE2 1
+    #include <emmintrin.h>
+    // AVX2 kernels are compiled with a target attribute and only used if the CPU reports AVX2 at load time
+    #if defined(__GNUC__)
+        #define CONVERT_AVX2 1
+        #include <immintrin.h>
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define CONVERT_NEON 1
+    #include <arm_neon.h>
+#endif
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+    #define DLL_EXPORT __declspec(dllexport)
+#elif defined(__linux__) || defined(__APPLE__)
+    #define DLL_EXPORT __attribute__((visibility("default")))
+#else
+    #define DLL_EXPORT
+#endif
+
+enum ConvertKernelLevel { kernelScalar, kernelSSE2, kernelAVX2, kernelNEON };
+
+namespace {
+
+const float int16Scale = 1.0f / 32768;
+const float int24Scale = 1.0f / 8388608;
+const float int32Scale = 1.0f / 2147483648.0f;
+
+struct Int24 {
+    uint8_t bytes[3];
+};
+
+inline float readSample(const float* data, size_t index) {
+    return data[index];
+}
+
+inline float readSample(const int16_t* data, size_t index) {
+    return data[index] * int16Scale;
+}
+
+inline float readSample(const Int24* data, size_t index) {
+    const uint8_t* bytes = data[index].bytes;
+    int32_t value = (int32_t)((uint32_t)bytes[0] << 8 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 24) >> 8;
+    return value * int24Scale;
+}
+
+inline float readSample(const int32_t* data, size_t index) {
+    return (float)data[index] * int32Scale;
+}
+
+// Fixed channel counts get their own instantiation, so the inner loop unrolls and the strides are constants
+template<size_t channels, typename Sample>
+void deinterleaveFixed(const Sample* interleaved, size_t start, size_t length, float* const* planar) {
+    for (size_t i = start; i < length; ++i) {
+        for (size_t c = 0; c < channels; ++c) {
+            planar[c][i] = readSample(interleaved, i * channels + c);
+        }
+    }
+}
+
+template<typename Sample>
+void deinterleaveAny(const Sample* interleaved, size_t channels, size_t start, size_t length, float* const* planar) {
+    for (size_t i = start; i < length; ++i) {
+        for (size_t c = 0; c < channels; ++c) {
+            planar[c][i] = readSample(interleaved, i * channels + c);
+        }
+    }
+}
+
+template<size_t channels>
+void interleaveFixed(const float* const* planar, size_t start, size_t length, float* interleaved) {
+    for (size_t i = start; i < length; ++i) {
+        for (size_t c = 0; c < channels; ++c) {
+            interleaved[i * channels + c] = planar[c][i];
+        }
+    }
+}
+
+void interleaveAny(const float* const* planar, size_t channels, size_t start, size_t length, float* interleaved) {
+    for (size_t i = start; i < length; ++i) {
+        for (size_t c = 0; c < channels; ++c) {
+            interleaved[i * channels + c] = planar[c][i];
+        }
+    }
+}
+
+// Stereo float kernels, returning how many frames they handled (the caller finishes the rest)
+
+size_t deinterleaveStereoScalar(const float*, size_t, float*, float*) {
+    return 0;
+}
+
+size_t interleaveStereoScalar(const float*, const float*, size_t, float*) {
+    return 0;
+}
+
+#if CONVERT_SSE2
+size_t deinterleaveStereoSSE2(const float* interleaved, size_t length, float* left, float* right) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128 a = _mm_loadu_ps(interleaved + 2 * i);
+        __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    return i;
+}
+
+size_t interleaveStereoSSE2(const float* left, const float* right, size_t length, float* interleaved) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+    return i;
+}
+#endif
+
+#if CONVERT_AVX2
+__attribute__((target("avx2")))
+size_t deinterleaveStereoAVX2(const float* interleaved, size_t length, float* left, float* right) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256 a = _mm256_loadu_ps(interleaved + 2 * i);
+        __m256 b = _mm256_loadu_ps(interleaved + 2 * i + 8);
+        // per 128-bit lane, so the results come out as frames 0 1 4 5 | 2 3 6 7
+        __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm256_storeu_ps(left + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+        _mm256_storeu_ps(right + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t interleaveStereoAVX2(const float* left, const float* right, size_t length, float* interleaved) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        __m256 low = _mm256_unpacklo_ps(l, r);  // frames 0 1 | 4 5
+        __m256 high = _mm256_unpackhi_ps(l, r); // frames 2 3 | 6 7
+        _mm256_storeu_ps(interleaved + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+        _mm256_storeu_ps(interleaved + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+    return i;
+}
+#endif
+
+#if CONVERT_NEON
+size_t deinterleaveStereoNEON(const float* interleaved, size_t length, float* left, float* right) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float32x4x2_t frames = vld2q_f32(interleaved + 2 * i);
+        vst1q_f32(left + i, frames.val[0]);
+        vst1q_f32(right + i, frames.val[1]);
+    }
+    return i;
+}
+
+size_t interleaveStereoNEON(const float* left, const float* right, size_t length, float* interleaved) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float32x4x2_t frames;
+        frames.val[0] = vld1q_f32(left + i);
+        frames.val[1] = vld1q_f32(right + i);
+        vst2q_f32(interleaved + 2 * i, frames);
+    }
+    return i;
+}
+#endif
+
+// Four-channel float and stereo int16 kernels are plain SSE2/NEON, which every supported CPU has
+
+size_t deinterleaveQuad(const float* interleaved, size_t length, float* const* planar) {
+    size_t i = 0;
+#if CONVERT_SSE2
+    for (; i + 4 <= length; i += 4) {
+        __m128 a = _mm_loadu_ps(interleaved + 4 * i);
+        __m128 b = _mm_loadu_ps(interleaved + 4 * i + 4);
+        __m128 c = _mm_loadu_ps(interleaved + 4 * i + 8);
+        __m128 d = _mm_loadu_ps(interleaved + 4 * i + 12);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_storeu_ps(planar[0] + i, a);
+        _mm_storeu_ps(planar[1] + i, b);
+        _mm_storeu_ps(planar[2] + i, c);
+        _mm_storeu_ps(planar[3] + i, d);
+    }
+#elif CONVERT_NEON
+    for (; i + 4 <= length; i += 4) {
+        float32x4x4_t frames = vld4q_f32(interleaved + 4 * i);
+        for (int c = 0; c < 4; ++c) vst1q_f32(planar[c] + i, frames.val[c]);
+    }
+#endif
+    return i;
+}
+
+size_t interleaveQuad(const float* const* planar, size_t length, float* interleaved) {
+    size_t i = 0;
+#if CONVERT_SSE2
+    for (; i + 4 <= length; i += 4) {
+        __m128 a = _mm_loadu_ps(planar[0] + i);
+        __m128 b = _mm_loadu_ps(planar[1] + i);
+        __m128 c = _mm_loadu_ps(planar[2] + i);
+        __m128 d = _mm_loadu_ps(planar[3] + i);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_storeu_ps(interleaved + 4 * i, a);
+        _mm_storeu_ps(interleaved + 4 * i + 4, b);
+        _mm_storeu_ps(interleaved + 4 * i + 8, c);
+        _mm_storeu_ps(interleaved + 4 * i + 12, d);
+    }
+#elif CONVERT_NEON
+    for (; i + 4 <= length; i += 4) {
+        float32x4x4_t frames;
+        for (int c = 0; c < 4; ++c) frames.val[c] = vld1q_f32(planar[c] + i);
+        vst4q_f32(interleaved + 4 * i, frames);
+    }
+#endif
+    return i;
+}
+
+size_t deinterleaveStereoInt16(const int16_t* interleaved, size_t length, float* left, float* right) {
+    size_t i = 0;
+#if CONVERT_SSE2
+    const __m128 scale = _mm_set1_ps(int16Scale);
+    for (; i + 4 <= length; i += 4) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(interleaved + 2 * i));
+        // sign-extend by unpacking into the top half of each 32-bit lane, then shifting back down
+        __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16)), scale);
+        __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16)), scale);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif CONVERT_NEON
+    for (; i + 4 <= length; i += 4) {
+        int16x4x2_t frames = vld2_s16(interleaved + 2 * i);
+        vst1q_f32(left + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(frames.val[0])), int16Scale));
+        vst1q_f32(right + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(frames.val[1])), int16Scale));
+    }
+#endif
+    return i;
+}
+
+size_t int16ToFloat(const int16_t* input, size_t count, float* output) {
+    size_t i = 0;
+#if CONVERT_SSE2
+    const __m128 scale = _mm_set1_ps(int16Scale);
+    for (; i + 8 <= count; i += 8) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16)), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16)), scale));
+    }
+#elif CONVERT_NEON
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t raw = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw))), int16Scale));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw))), int16Scale));
+    }
+#endif
+    return i;
+}
+
+size_t int32ToFloat(const int32_t* input, size_t count, float* output) {
+    size_t i = 0;
+#if CONVERT_SSE2
+    const __m128 scale = _mm_set1_ps(int32Scale);
+    for (; i + 4 <= count; i += 4) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(raw), scale));
+    }
+#elif CONVERT_NEON
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(input + i)), int32Scale));
+    }
+#endif
+    return i;
+}
+
+// Stereo float kernels picked once at load time
+struct Kernels {
+    size_t (*deinterleaveStereo)(const float* interleaved, size_t length, float* left, float* right);
+    size_t (*interleaveStereo)(const float* left, const float* right, size_t length, float* interleaved);
+    ConvertKernelLevel level;
+};
+
+Kernels selectKernels() {
+    Kernels kernels = {deinterleaveStereoScalar, interleaveStereoScalar, kernelScalar};
+#if CONVERT_SSE2
+    kernels = {deinterleaveStereoSSE2, interleaveStereoSSE2, kernelSSE2};
+#endif
+#if CONVERT_AVX2
+    // this runs during static initialisation, possibly before libgcc has filled in the CPU model it reads
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels = {deinterleaveStereoAVX2, interleaveStereoAVX2, kernelAVX2};
+    }
+#endif
+#if CONVERT_NEON
+    kernels = {deinterleaveStereoNEON, interleaveStereoNEON, kernelNEON};
+#endif
+    return kernels;
+}
+
+const Kernels kernels = selectKernels();
+
+template<typename Sample>
+void deinterleaveSamples(const Sample* interleaved, size_t channels, size_t length, float* const* planar) {
+    switch (channels) {
+        case 1: return deinterleaveFixed<1>(interleaved, 0, length, planar);
+        case 2: return deinterleaveFixed<2>(interleaved, 0, length, planar);
+        case 4: return deinterleaveFixed<4>(interleaved, 0, length, planar);
+        case 6: return deinterleaveFixed<6>(interleaved, 0, length, planar);
+        case 8: return deinterleaveFixed<8>(interleaved, 0, length, planar);
+    }
+    deinterleaveAny(interleaved, channels, 0, length, planar);
+}
+
+void deinterleaveFloat(const float* interleaved, size_t channels, size_t length, float* const* planar) {
+    size_t done;
+    switch (channels) {
+        case 1:
+            std::memcpy(planar[0], interleaved, length * sizeof(float));
+            return;
+        case 2:
+            done = kernels.deinterleaveStereo(interleaved, length, planar[0], planar[1]);
+            return deinterleaveFixed<2>(interleaved, done, length, planar);
+        case 4:
+            done = deinterleaveQuad(interleaved, length, planar);
+            return deinterleaveFixed<4>(interleaved, done, length, planar);
+    }
+    deinterleaveSamples(interleaved, channels, length, planar);
+}
+
+void deinterleaveInt16(const int16_t* interleaved, size_t channels, size_t length, float* const* planar) {
+    size_t done;
+    switch (channels) {
+        case 1:
+            done = int16ToFloat(interleaved, length, planar[0]);
+            return deinterleaveFixed<1>(interleaved, done, length, planar);
+        case 2:
+            done = deinterleaveStereoInt16(interleaved, length, planar[0], planar[1]);
+            return deinterleaveFixed<2>(interleaved, done, length, planar);
+    }
+    deinterleaveSamples(interleaved, channels, length, planar);
+}
+
+} // namespace
+
+size_t Binding_SampleBytes(SampleFormat format) {
+    switch (format) {
+        case sampleInt16: return 2;
+        case sampleInt24: return 3;
+        default: return 4;
+    }
+}
+
+void Binding_Deinterleave(const void* interleaved, SampleFormat format, size_t channels, size_t length, float* const* planar) {
+    if (!length) return;
+    switch (format) {
+        case sampleFloat32: return deinterleaveFloat(static_cast<const float*>(interleaved), channels, length, planar);
+        case sampleInt16: return deinterleaveInt16(static_cast<const int16_t*>(interleaved), channels, length, planar);
+        case sampleInt24: return deinterleaveSamples(static_cast<const Int24*>(interleaved), channels, length, planar);
+        case sampleInt32: return deinterleaveSamples(static_cast<const int32_t*>(interleaved), channels, length, planar);
+    }
+}
+
+void Binding_Interleave(const float* const* planar, size_t channels, size_t length, float* interleaved) {
+    if (!length) return;
+    size_t done;
+    switch (channels) {
+        case 1:
+            std::memcpy(interleaved, planar[0], length * sizeof(float));
+            return;
+        case 2:
+            done = kernels.interleaveStereo(planar[0], planar[1], length, interleaved);
+            return interleaveFixed<2>(planar, done, length, interleaved);
+        case 4:
+            done = interleaveQuad(planar, length, interleaved);
+            return interleaveFixed<4>(planar, done, length, interleaved);
+        case 6: return interleaveFixed<6>(planar, 0, length, interleaved);
+        case 8: return interleaveFixed<8>(planar, 0, length, interleaved);
+    }
+    interleaveAny(planar, channels, 0, length, interleaved);
+}
+
+void Binding_ToFloat(const void* input, SampleFormat format, size_t count, float* output) {
+    if (!count) return;
+    float* const planar[1] = {output};
+    size_t done;
+    switch (format) {
+        case sampleFloat32:
+            std::memcpy(output, input, count * sizeof(float));
+            return;
+        case sampleInt16:
+            done = int16ToFloat(static_cast<const int16_t*>(input), count, output);
+            return deinterleaveFixed<1>(static_cast<const int16_t*>(input), done, count, planar);
+        case sampleInt24:
+            return deinterleaveFixed<1>(static_cast<const Int24*>(input), 0, count, planar);
+        case sampleInt32:
+            done = int32ToFloat(static_cast<const int32_t*>(input), count, output);
+            return deinterleaveFixed<1>(static_cast<const int32_t*>(input), done, count, planar);
+    }
+}
+
+extern "C" {
+    // `format` is a SampleFormat: 0 float, 1 int16, 2 packed int24, 3 int32
+    DLL_EXPORT void Convert_ToFloat(const void* input, int format, size_t count, float* output) {
+        Binding_ToFloat(input, (SampleFormat)format, count, output);
+    }
+
+    DLL_EXPORT void Convert_Deinterleave(const void* interleaved, int format, int channels, size_t length, float* const* planar) {
+        Binding_Deinterleave(interleaved, (SampleFormat)format, channels, length, planar);
+    }
+
+    DLL_EXPORT void Convert_Interleave(const float* const* planar, int channels, size_t length, float* interleaved) {
+        Binding_Interleave(planar, channels, length, interleaved);
+    }
+
+    // Which stereo kernels were selected: 0 scalar, 1 SSE2, 2 AVX2, 3 NEON
+    DLL_EXPORT int Convert_KernelLevel() {
+        return kernels.level;
+    }
+}
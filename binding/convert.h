@@ -0,0 +1,20 @@
+// Interleave/deinterleave and sample-format conversion shared by the binding's translation units.
+// Implemented in convert.cpp, which picks SSE2, AVX2 or NEON kernels for the common layouts at load time.
+#pragma once
+
+#include <cstddef>
+
+// Sample formats accepted by the conversion functions. int24 is packed little-endian, three bytes per sample.
+enum SampleFormat { sampleFloat32, sampleInt16, sampleInt24, sampleInt32 };
+
+// Bytes per sample of `format`
+size_t Binding_SampleBytes(SampleFormat format);
+
+// Splits `length` interleaved frames of `channels` channels into one float buffer per channel
+void Binding_Deinterleave(const void* interleaved, SampleFormat format, size_t channels, size_t length, float* const* planar);
+
+// Merges one float buffer per channel into `length` interleaved frames
+void Binding_Interleave(const float* const* planar, size_t channels, size_t length, float* interleaved);
+
+// Converts `count` samples to float, scaled to [-1, 1)
+void Binding_ToFloat(const void* input, SampleFormat format, size_t count, float* output);
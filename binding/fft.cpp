@@ -1,5 +1,9 @@
 #include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 #include "signalsmith-linear/fft.h"
+#include "./allocator.h"
 
 #if defined(_WIN32) || defined(__CYGWIN__)
     #define DLL_EXPORT __declspec(dllexport)
@@ -9,25 +13,90 @@
     #define DLL_EXPORT
 #endif
 
+// Read-only buffers shared by every instance of the same size, and freed with the last one using them.
+// Only touched when instances are created or resized.
+struct SharedZeros {
+    std::mutex mutex;
+    typedef std::pair<const size_t, std::weak_ptr<const HookVector<float>>> Entry;
+    std::map<size_t, std::weak_ptr<const HookVector<float>>, std::less<size_t>, HookAllocator<Entry>> buffers;
+
+    std::shared_ptr<const HookVector<float>> get(size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<const HookVector<float>> buffer = buffers[size].lock();
+        if (!buffer) {
+            // separate control block, so the buffer itself is freed as soon as no instance uses it
+            buffer = std::shared_ptr<HookVector<float>>(hookNew<HookVector<float>>(size, 0.0f), hookDelete<HookVector<float>>, HookAllocator<HookVector<float>>());
+            buffers[size] = buffer;
+        }
+        for (auto it = buffers.begin(); it != buffers.end();) {
+            it = it->second.expired() ? buffers.erase(it) : std::next(it);
+        }
+        return buffer;
+    }
+
+    size_t bytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        for (auto& entry : buffers) {
+            std::shared_ptr<const HookVector<float>> buffer = entry.second.lock();
+            if (buffer) total += buffer->capacity() * sizeof(float);
+        }
+        return total;
+    }
+};
+
+static SharedZeros sharedZeros;
+
 struct FFT {
     signalsmith::linear::FFT<float> fft;
 
-    std::vector<std::complex<float>> inputBuffer;
-    std::vector<std::complex<float>> outputBuffer;
+    // stands in for a null imaginary input on the split-array paths
+    std::shared_ptr<const HookVector<float>> zeros;
+
+    void resize(size_t size) {
+        fft.resize(size);
+        zeros = sharedZeros.get(fft.size());
+    }
 };
 
+// Real-input FFT. signalsmith::linear::RealFFT produces N/2 bins with the (real) Nyquist value packed into the
+// imaginary part of bin 0; these wrappers unpack that so callers always see N/2+1 bins.
+struct RealFFT {
+    signalsmith::linear::RealFFT<float> fft;
+
+    // packed copy of the spectrum for the inverse transforms, which must not modify the caller's input
+    HookVector<std::complex<float>> packed;
+    HookVector<float> packedImag;
+
+    void resize(size_t size) {
+        fft.resize(size);
+        packed.assign(fft.size() / 2, 0.0f);
+        packedImag.assign(fft.size() / 2, 0.0f);
+    }
+};
+
+// std::complex<float> is layout-compatible with float[2], so interleaved buffers can be passed through as-is
+static const std::complex<float>* asComplex(const float* interleaved) {
+    return reinterpret_cast<const std::complex<float>*>(interleaved);
+}
+
+static std::complex<float>* asComplex(float* interleaved) {
+    return reinterpret_cast<std::complex<float>*>(interleaved);
+}
+
 extern "C" {
     DLL_EXPORT FFT* FFT_Create(size_t size) {
-        FFT* fft = new FFT();
+        FFT* fft = hookNew<FFT>();
+        fft->resize(size);
         return fft;
     }
 
     DLL_EXPORT void FFT_Delete(FFT* fft) {
-        delete fft;
+        hookDelete(fft);
     }
 
     DLL_EXPORT void FFT_Resize(FFT* fft, size_t size) {
-        fft->fft.resize(size);
+        fft->resize(size);
     }
 
     DLL_EXPORT size_t FFT_Size(FFT* fft) {
@@ -39,35 +108,11 @@ extern "C" {
     }
 
     DLL_EXPORT void FFT_Proc(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
-        size_t size = fft->fft.size();
-        fft->inputBuffer.resize(size);
-        fft->outputBuffer.resize(size);
-
-        for (size_t i = 0; i < size; ++i) {
-            fft->inputBuffer[i] = std::complex<float>(inputReal[i], inputImag ? inputImag[i] : 0.0f);
-        }
-
-        fft->fft.fft(fft->inputBuffer.data(), fft->outputBuffer.data());
-        for (size_t i = 0; i < size; ++i) {
-            outputReal[i] = fft->outputBuffer[i].real();
-            outputImag[i] = fft->outputBuffer[i].imag();
-        }
+        fft->fft.fft(inputReal, inputImag ? inputImag : fft->zeros->data(), outputReal, outputImag);
     }
 
     DLL_EXPORT void FFT_ProcStep(FFT* fft, size_t step, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
-        size_t size = fft->fft.size();
-        fft->inputBuffer.resize(size);
-        fft->outputBuffer.resize(size);
-
-        for (size_t i = 0; i < size; ++i) {
-            fft->inputBuffer[i] = std::complex<float>(inputReal[i], inputImag ? inputImag[i] : 0.0f);
-        }
-
-        fft->fft.fft(step, fft->inputBuffer.data(), fft->outputBuffer.data());
-        for (size_t i = 0; i < size; ++i) {
-            outputReal[i] = fft->outputBuffer[i].real();
-            outputImag[i] = fft->outputBuffer[i].imag();
-        }
+        fft->fft.fft(step, inputReal, inputImag ? inputImag : fft->zeros->data(), outputReal, outputImag);
     }
 
     DLL_EXPORT void FFT_ProcSplit(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
@@ -78,35 +123,20 @@ extern "C" {
         fft->fft.fft(step, inputReal, inputImag, outputReal, outputImag);
     }
 
-    DLL_EXPORT void FFT_InverseProc(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
-        size_t size = fft->fft.size();
-        fft->inputBuffer.resize(size);
-        fft->outputBuffer.resize(size);
-
-        for (size_t i = 0; i < size; ++i) {
-            fft->inputBuffer[i] = std::complex<float>(inputReal[i], inputImag ? inputImag[i] : 0.0f);
-        }
-        fft->fft.ifft(fft->inputBuffer.data(), fft->outputBuffer.data());
-        for (size_t i = 0; i < size; ++i) {
-            outputReal[i] = fft->outputBuffer[i].real();
-            outputImag[i] = fft->outputBuffer[i].imag();
-        }
+    DLL_EXPORT void FFT_ProcComplex(FFT* fft, const float* interleavedInput, float* interleavedOutput) {
+        fft->fft.fft(asComplex(interleavedInput), asComplex(interleavedOutput));
     }
 
-    DLL_EXPORT void FFT_InverseProcStep(FFT* fft, size_t step, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
-        size_t size = fft->fft.size();
-        fft->inputBuffer.resize(size);
-        fft->outputBuffer.resize(size);
+    DLL_EXPORT void FFT_ProcComplexStep(FFT* fft, size_t step, const float* interleavedInput, float* interleavedOutput) {
+        fft->fft.fft(step, asComplex(interleavedInput), asComplex(interleavedOutput));
+    }
 
-        for (size_t i = 0; i < size; ++i) {
-            fft->inputBuffer[i] = std::complex<float>(inputReal[i], inputImag ? inputImag[i] : 0.0f);
-        }
+    DLL_EXPORT void FFT_InverseProc(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
+        fft->fft.ifft(inputReal, inputImag ? inputImag : fft->zeros->data(), outputReal, outputImag);
+    }
 
-        fft->fft.ifft(step, fft->inputBuffer.data(), fft->outputBuffer.data());
-        for (size_t i = 0; i < size; ++i) {
-            outputReal[i] = fft->outputBuffer[i].real();
-            outputImag[i] = fft->outputBuffer[i].imag();
-        }
+    DLL_EXPORT void FFT_InverseProcStep(FFT* fft, size_t step, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
+        fft->fft.ifft(step, inputReal, inputImag ? inputImag : fft->zeros->data(), outputReal, outputImag);
     }
 
     DLL_EXPORT void FFT_InverseProcSplit(FFT* fft, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
@@ -116,4 +146,106 @@ extern "C" {
     DLL_EXPORT void FFT_InverseProcSplitStep(FFT* fft, size_t step, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag) {
         fft->fft.ifft(step, inputReal, inputImag, outputReal, outputImag);
     }
+
+    DLL_EXPORT void FFT_InverseProcComplex(FFT* fft, const float* interleavedInput, float* interleavedOutput) {
+        fft->fft.ifft(asComplex(interleavedInput), asComplex(interleavedOutput));
+    }
+
+    DLL_EXPORT void FFT_InverseProcComplexStep(FFT* fft, size_t step, const float* interleavedInput, float* interleavedOutput) {
+        fft->fft.ifft(step, asComplex(interleavedInput), asComplex(interleavedOutput));
+    }
+
+    // Transforms `frames` equal-size frames in one call. Frame f starts at offset f*strideFrames in every array
+    // (strideFrames is in samples, and 0 means the frames are packed back-to-back at the FFT size).
+    // A null inputImag is treated as zeros, as for FFT_Proc.
+    DLL_EXPORT void FFT_ProcBatch(FFT* fft, int frames, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag, size_t strideFrames) {
+        size_t stride = strideFrames ? strideFrames : fft->fft.size();
+        for (int f = 0; f < frames; ++f) {
+            size_t offset = (size_t)f * stride;
+            fft->fft.fft(inputReal + offset, inputImag ? inputImag + offset : fft->zeros->data(), outputReal + offset, outputImag + offset);
+        }
+    }
+
+    DLL_EXPORT void FFT_InverseProcBatch(FFT* fft, int frames, const float* inputReal, const float* inputImag, float* outputReal, float* outputImag, size_t strideFrames) {
+        size_t stride = strideFrames ? strideFrames : fft->fft.size();
+        for (int f = 0; f < frames; ++f) {
+            size_t offset = (size_t)f * stride;
+            fft->fft.ifft(inputReal + offset, inputImag ? inputImag + offset : fft->zeros->data(), outputReal + offset, outputImag + offset);
+        }
+    }
+
+    // Heap bytes held by the binding for this instance. Buffers shared between instances are counted once by
+    // FFT_SharedMemoryFootprint. The transform's own twiddles and working buffers are allocated inside
+    // signalsmith-linear through the standard allocator, so they are neither shared nor included here.
+    DLL_EXPORT size_t FFT_MemoryFootprint(FFT* fft) {
+        return sizeof(*fft);
+    }
+
+    DLL_EXPORT size_t FFT_SharedMemoryFootprint() {
+        return sharedZeros.bytes();
+    }
+
+    // The packed inverse needs DC and Nyquist in separate bins, so sizes below 2 are rejected (nullptr)
+    DLL_EXPORT RealFFT* RealFFT_Create(size_t size) {
+        if (size < 2) return nullptr;
+        RealFFT* fft = hookNew<RealFFT>();
+        fft->resize(size);
+        return fft;
+    }
+
+    DLL_EXPORT void RealFFT_Delete(RealFFT* fft) {
+        hookDelete(fft);
+    }
+
+    // Sizes below 2 leave the current size in place
+    DLL_EXPORT void RealFFT_Resize(RealFFT* fft, size_t size) {
+        if (size < 2) return;
+        fft->resize(size);
+    }
+
+    DLL_EXPORT size_t RealFFT_Size(RealFFT* fft) {
+        return fft->fft.size();
+    }
+
+    // Number of output bins, N/2 + 1
+    DLL_EXPORT size_t RealFFT_Bands(RealFFT* fft) {
+        return fft->fft.size() / 2 + 1;
+    }
+
+    DLL_EXPORT size_t RealFFT_MemoryFootprint(RealFFT* fft) {
+        return sizeof(RealFFT) + fft->packed.capacity() * sizeof(std::complex<float>) + fft->packedImag.capacity() * sizeof(float);
+    }
+
+    DLL_EXPORT void RealFFT_Proc(RealFFT* fft, const float* input, float* outputReal, float* outputImag) {
+        size_t half = fft->fft.size() / 2;
+        fft->fft.fft(input, outputReal, outputImag);
+        outputReal[half] = outputImag[0];
+        outputImag[half] = 0;
+        outputImag[0] = 0;
+    }
+
+    DLL_EXPORT void RealFFT_ProcComplex(RealFFT* fft, const float* input, float* interleavedOutput) {
+        size_t half = fft->fft.size() / 2;
+        std::complex<float>* output = asComplex(interleavedOutput);
+        fft->fft.fft(input, output);
+        output[half] = output[0].imag();
+        output[0] = output[0].real();
+    }
+
+    DLL_EXPORT void RealFFT_InverseProc(RealFFT* fft, const float* inputReal, const float* inputImag, float* output) {
+        size_t half = fft->fft.size() / 2;
+        float* packedImag = fft->packedImag.data();
+        packedImag[0] = inputReal[half];
+        std::memcpy(packedImag + 1, inputImag + 1, (half - 1) * sizeof(float));
+        fft->fft.ifft(inputReal, packedImag, output);
+    }
+
+    DLL_EXPORT void RealFFT_InverseProcComplex(RealFFT* fft, const float* interleavedInput, float* output) {
+        size_t half = fft->fft.size() / 2;
+        const std::complex<float>* input = asComplex(interleavedInput);
+        std::complex<float>* packed = fft->packed.data();
+        std::memcpy((void*)packed, (const void*)input, half * sizeof(std::complex<float>));
+        packed[0] = std::complex<float>(input[0].real(), input[half].real());
+        fft->fft.ifft(packed, output);
+    }
 }
\ No newline at end of file
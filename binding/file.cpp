@@ -0,0 +1,270 @@
+// 64-bit file offsets for mmap and ftruncate on 32-bit POSIX targets
+#define _FILE_OFFSET_BITS 64
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "./file.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <vector>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(_WIN32)
+HANDLE openFile(const char* path, bool create) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    if (length <= 0) return INVALID_HANDLE_VALUE;
+    std::vector<wchar_t> widePath(length);
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath.data(), length);
+    if (create) {
+        return CreateFileW(widePath.data(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    }
+    return CreateFileW(widePath.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+}
+
+// Window offsets must be multiples of this
+size_t mapGranularity() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+#else
+size_t mapGranularity() {
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+#endif
+
+void unmapWindow(MappedFile& file) {
+    if (!file.window) return;
+#if defined(_WIN32)
+    if (file.writable) FlushViewOfFile(file.window, file.windowSize);
+    UnmapViewOfFile(file.window);
+#else
+    if (file.writable) msync(file.window, file.windowSize, MS_ASYNC);
+    munmap(file.window, file.windowSize);
+#endif
+    file.window = nullptr;
+    file.windowOffset = 0;
+    file.windowSize = 0;
+}
+
+// Headers are parsed through windows of this size, so the chunks of a typical file are all mapped at once
+const size_t wavParseWindow = 64 << 10;
+
+uint16_t readU16(const unsigned char* bytes) {
+    return (uint16_t)(bytes[0] | bytes[1] << 8);
+}
+
+uint32_t readU32(const unsigned char* bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+void writeU16(unsigned char* bytes, uint16_t value) {
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+}
+
+void writeU32(unsigned char* bytes, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+bool Binding_MapRead(const char* path, MappedFile& file) {
+    file = MappedFile();
+#if defined(_WIN32)
+    HANDLE handle = openFile(path, false);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+    file.file = handle;
+    file.mapping = mapping;
+    file.size = (unsigned long long)size.QuadPart;
+#else
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) return false;
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+        close(descriptor);
+        return false;
+    }
+    file.descriptor = descriptor;
+    file.size = (unsigned long long)status.st_size;
+#endif
+    return true;
+}
+
+bool Binding_MapCreate(const char* path, unsigned long long size, MappedFile& file) {
+    file = MappedFile();
+    file.writable = true;
+    if (size > (unsigned long long)std::numeric_limits<long long>::max()) return false;
+#if defined(_WIN32)
+    HANDLE handle = openFile(path, true);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    file.file = handle;
+    file.size = size;
+    if (size == 0) return true;
+    // Creating the mapping extends the file to its full size
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, nullptr);
+    if (!mapping) {
+        Binding_Unmap(file);
+        return false;
+    }
+    file.mapping = mapping;
+#else
+    int descriptor = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) return false;
+    file.descriptor = descriptor;
+    file.size = size;
+    if (size == 0) return true;
+    if (ftruncate(descriptor, (off_t)size) != 0) {
+        Binding_Unmap(file);
+        return false;
+    }
+#if defined(__linux__)
+    // Reserve the blocks now, so a full disk fails here instead of faulting while writing through the mapping
+    int reserved = posix_fallocate(descriptor, 0, (off_t)size);
+    if (reserved != 0 && reserved != EINVAL && reserved != EOPNOTSUPP) {
+        Binding_Unmap(file);
+        return false;
+    }
+#endif
+#endif
+    return true;
+}
+
+unsigned char* Binding_MapRange(MappedFile& file, unsigned long long begin, size_t length, size_t minWindow) {
+    if (length == 0 || begin > file.size || length > file.size - begin) return nullptr;
+    if (file.window && begin >= file.windowOffset && length <= file.windowSize && begin - file.windowOffset <= file.windowSize - length) {
+        return file.window + (begin - file.windowOffset);
+    }
+    unmapWindow(file);
+
+    unsigned long long offset = begin / mapGranularity() * mapGranularity();
+    unsigned long long span = std::max(length, minWindow);
+    unsigned long long end = span > file.size - begin ? file.size : begin + span;
+    if (end - offset > (unsigned long long)std::numeric_limits<size_t>::max()) {
+        end = begin + length; // fall back to the smallest window that covers the range
+        if (end - offset > (unsigned long long)std::numeric_limits<size_t>::max()) return nullptr;
+    }
+    size_t bytes = (size_t)(end - offset);
+#if defined(_WIN32)
+    void* data = MapViewOfFile(file.mapping, file.writable ? FILE_MAP_WRITE : FILE_MAP_READ, (DWORD)(offset >> 32), (DWORD)offset, bytes);
+    if (!data) return nullptr;
+#else
+    void* data = mmap(nullptr, bytes, file.writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.descriptor, (off_t)offset);
+    if (data == MAP_FAILED) return nullptr;
+    madvise(data, bytes, MADV_SEQUENTIAL);
+#endif
+    file.window = static_cast<unsigned char*>(data);
+    file.windowOffset = offset;
+    file.windowSize = bytes;
+    return file.window + (begin - offset);
+}
+
+void Binding_Unmap(MappedFile& file) {
+    unmapWindow(file);
+#if defined(_WIN32)
+    if (file.mapping) CloseHandle(file.mapping);
+    if (file.file) CloseHandle(file.file);
+#else
+    if (file.descriptor >= 0) close(file.descriptor);
+#endif
+    file = MappedFile();
+}
+
+bool Binding_ParseWav(MappedFile& file, WavInfo& info) {
+    unsigned long long size = file.size;
+    const unsigned char* riff = Binding_MapRange(file, 0, 12, wavParseWindow);
+    if (!riff || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) return false;
+
+    bool haveFormat = false;
+    uint16_t formatTag = 0, bits = 0;
+    size_t blockAlign = 0;
+    // 64-bit offsets, and every chunk is checked against the file length before stepping over it, so neither the
+    // offsets nor the chunk sizes read from the file can wrap
+    for (unsigned long long offset = 12; offset <= size - 8;) {
+        const unsigned char* chunk = Binding_MapRange(file, offset, 8, wavParseWindow);
+        if (!chunk) return false;
+        bool isFormat = std::memcmp(chunk, "fmt ", 4) == 0, isData = std::memcmp(chunk, "data", 4) == 0;
+        unsigned long long chunkSize = readU32(chunk + 4);
+        unsigned long long body = offset + 8;
+        unsigned long long available = size - body;
+        if (isFormat && chunkSize >= 16 && available >= 16) {
+            bool extensible = chunkSize >= 40 && available >= 40;
+            const unsigned char* format = Binding_MapRange(file, body, extensible ? 40 : 16, wavParseWindow);
+            if (!format) return false;
+            formatTag = readU16(format);
+            info.channels = readU16(format + 2);
+            info.sampleRate = (float)readU32(format + 4);
+            blockAlign = readU16(format + 12);
+            bits = readU16(format + 14);
+            if (formatTag == 0xFFFE && extensible) {
+                formatTag = readU16(format + 24); // first two bytes of the subformat GUID
+            }
+            haveFormat = true;
+        } else if (isData) {
+            if (!haveFormat || info.channels <= 0) return false;
+            if (formatTag == 1 && bits == 16) {
+                info.format = sampleInt16;
+            } else if (formatTag == 1 && bits == 24) {
+                info.format = sampleInt24;
+            } else if (formatTag == 1 && bits == 32) {
+                info.format = sampleInt32;
+            } else if (formatTag == 3 && bits == 32) {
+                info.format = sampleFloat32;
+            } else {
+                return false;
+            }
+            if (blockAlign != Binding_SampleBytes(info.format) * info.channels) return false;
+            // Streamed or >4GB files often leave the size as 0xFFFFFFFF, so never read past the file
+            if (chunkSize > available || chunkSize == 0xFFFFFFFFu) chunkSize = available;
+            info.dataOffset = body;
+            info.frames = chunkSize / blockAlign;
+            return true;
+        }
+        if (chunkSize + (chunkSize & 1) > available) return false; // truncated before the data chunk
+        offset = body + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+void Binding_WriteWavHeader(unsigned char* header, int channels, float sampleRate, unsigned long long frames) {
+    uint64_t dataBytes = (uint64_t)frames * channels * sizeof(float);
+    uint32_t blockAlign = (uint32_t)(channels * sizeof(float));
+    std::memcpy(header, "RIFF", 4);
+    writeU32(header + 4, dataBytes + 36 > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)(dataBytes + 36));
+    std::memcpy(header + 8, "WAVE", 4);
+    std::memcpy(header + 12, "fmt ", 4);
+    writeU32(header + 16, 16);
+    writeU16(header + 20, 3); // WAVE_FORMAT_IEEE_FLOAT
+    writeU16(header + 22, (uint16_t)channels);
+    writeU32(header + 24, (uint32_t)sampleRate);
+    writeU32(header + 28, (uint32_t)(sampleRate * blockAlign));
+    writeU16(header + 32, (uint16_t)blockAlign);
+    writeU16(header + 34, 32);
+    std::memcpy(header + 36, "data", 4);
+    writeU32(header + 40, dataBytes > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)dataBytes);
+}
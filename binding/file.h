@@ -0,0 +1,53 @@
+// Memory-mapped audio files for Stretch_RenderFile. Implemented in file.cpp with mmap, or file mappings on Windows.
+// Only a window of each file is mapped at a time, so files larger than the address space can be rendered, and
+// finished pages leave the working set as the window moves on.
+#pragma once
+
+#include <cstddef>
+#include "./convert.h"
+
+struct MappedFile {
+    unsigned long long size = 0; // file length in bytes
+    bool writable = false;
+    unsigned char* window = nullptr; // bytes [windowOffset, windowOffset + windowSize) of the file
+    unsigned long long windowOffset = 0;
+    size_t windowSize = 0;
+#if defined(_WIN32)
+    void* file = nullptr;    // HANDLE
+    void* mapping = nullptr; // HANDLE
+#else
+    int descriptor = -1;
+#endif
+};
+
+// Opens a non-empty file for reading, with nothing mapped yet. Returns false (with `file` left closed) on failure.
+bool Binding_MapRead(const char* path, MappedFile& file);
+
+// Creates (or truncates) a file of `size` bytes with its space reserved up front, to be written through windows
+bool Binding_MapCreate(const char* path, unsigned long long size, MappedFile& file);
+
+// Returns a pointer to bytes [begin, begin + length) of the file, moving the window if they are not already in it.
+// A new window covers at least `minWindow` bytes from `begin` (stopping at the end of the file), and the old one is
+// unmapped, after starting to write it back if the file is writable. The pointer is valid until the next call.
+// Returns nullptr if `length` is 0, the range runs past the end of the file, or it can't be mapped.
+unsigned char* Binding_MapRange(MappedFile& file, unsigned long long begin, size_t length, size_t minWindow);
+
+// Unmaps the window and closes the file
+void Binding_Unmap(MappedFile& file);
+
+// Layout of the sample data in a WAV file
+struct WavInfo {
+    SampleFormat format;
+    int channels;
+    float sampleRate;
+    unsigned long long dataOffset;
+    unsigned long long frames;
+};
+
+// Reads the header of a WAV file: PCM 16/24/32-bit or 32-bit float, plain or WAVE_FORMAT_EXTENSIBLE. Moves the window.
+bool Binding_ParseWav(MappedFile& file, WavInfo& info);
+
+const size_t wavHeaderBytes = 44;
+
+// Writes a canonical 44-byte header for 32-bit float data. Sizes past 4GB are written as 0xFFFFFFFF.
+void Binding_WriteWavHeader(unsigned char* header, int channels, float sampleRate, unsigned long long frames);
@@ -1,5 +1,23 @@
 #include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include "./signalsmith-stretch/signalsmith-stretch.h"
+#include "./allocator.h"
+#include "./convert.h"
+#include "./file.h"
 
 #if defined(_WIN32) || defined(__CYGWIN__)
     #define DLL_EXPORT __declspec(dllexport)
@@ -9,10 +27,184 @@
     #define DLL_EXPORT
 #endif
 
+typedef void* (*StretchAllocFunction)(void* userData, size_t bytes);
+typedef void (*StretchFreeFunction)(void* userData, void* pointer);
+
+// Hooks set by Stretch_SetAllocator. Each block starts with a header naming the hooks that allocated it, so
+// blocks are always freed correctly even if the hooks are changed while instances are alive.
+struct AllocationHooks {
+    StretchAllocFunction alloc = nullptr;
+    StretchFreeFunction free = nullptr;
+    void* userData = nullptr;
+};
+
+union AllocationHeader {
+    struct {
+        StretchFreeFunction free;
+        void* userData;
+    } owner;
+    std::max_align_t alignment;
+};
+
+static AllocationHooks allocationHooks;
+static std::atomic<size_t> allocationCount(0);
+static thread_local AllocationCounter* allocationCounter = nullptr;
+
+void* Binding_Allocate(size_t bytes) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (allocationCounter) allocationCounter->fetch_add(1, std::memory_order_relaxed);
+
+    AllocationHooks hooks = allocationHooks;
+    size_t total = sizeof(AllocationHeader) + bytes;
+    void* block = hooks.alloc ? hooks.alloc(hooks.userData, total) : std::malloc(total);
+    if (!block) throw std::bad_alloc();
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(block);
+    header->owner.free = hooks.alloc ? hooks.free : nullptr;
+    header->owner.userData = hooks.userData;
+    return header + 1;
+}
+
+void Binding_Free(void* pointer) {
+    if (!pointer) return;
+    AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+    if (header->owner.free) {
+        header->owner.free(header->owner.userData, header);
+    } else {
+        std::free(header);
+    }
+}
+
+AllocationCounter* Binding_SwapAllocationCounter(AllocationCounter* counter) {
+    AllocationCounter* previous = allocationCounter;
+    allocationCounter = counter;
+    return previous;
+}
+
+void Binding_Configured() {
+    if (allocationCounter) allocationCounter->store(0, std::memory_order_relaxed);
+}
+
+// Build with STRETCH_STATS=1 (CMake option SIGNALSMITH_STRETCH_STATS) to record per-instance timing counters
+#ifndef STRETCH_STATS
+    #define STRETCH_STATS 0
+#endif
+
+struct StretchPipeline;
+struct StretchParamState;
+struct StretchStatsState;
+struct StretchScratch;
+struct StretchRender;
+struct StretchQuality;
+
 struct Stretch {
     int channels;
     float sampleRate;
     signalsmith::stretch::SignalsmithStretch<float>* stretch;
+    StretchPipeline* pipeline;
+    StretchParamState* params;
+    StretchStatsState* stats; // null unless built with STRETCH_STATS
+    StretchScratch* scratch;
+    StretchRender* render; // null until Stretch_RenderStart
+    StretchQuality* quality;
+    AllocationCounter allocations; // see Stretch_AllocationsSinceConfigure
+};
+
+// Snapshot filled by Stretch_GetStats
+struct StretchStats {
+    int64_t calls;
+    int64_t inputSamples;
+    int64_t outputSamples;
+    int64_t overBudget;         // calls that took longer than budgetMicroseconds
+    double totalMicroseconds;
+    double maxMicroseconds;
+    double budgetMicroseconds;  // 0 if no budget is set
+};
+
+// Settings reported by Stretch_GetLatencyConfig and Stretch_ConfigureForLatency
+struct StretchLatencyConfig {
+    int blockSamples;
+    int intervalSamples;
+    int splitComputation; // 0 or 1
+    int inputLatency;
+    int outputLatency;    // including the pipeline block, if pipelined
+    float latencyMs;      // inputLatency + outputLatency
+};
+
+// Written only by the thread calling Process, and read (or reset) from any thread
+struct StretchStatsState {
+    std::atomic<int64_t> calls;
+    std::atomic<int64_t> inputSamples;
+    std::atomic<int64_t> outputSamples;
+    std::atomic<int64_t> overBudget;
+    std::atomic<int64_t> totalNanoseconds;
+    std::atomic<int64_t> maxNanoseconds;
+    std::atomic<int64_t> budgetNanoseconds;
+
+    StretchStatsState() : calls(0), inputSamples(0), outputSamples(0), overBudget(0), totalNanoseconds(0), maxNanoseconds(0), budgetNanoseconds(0) {}
+
+    void reset() {
+        calls.store(0, std::memory_order_relaxed);
+        inputSamples.store(0, std::memory_order_relaxed);
+        outputSamples.store(0, std::memory_order_relaxed);
+        overBudget.store(0, std::memory_order_relaxed);
+        totalNanoseconds.store(0, std::memory_order_relaxed);
+        maxNanoseconds.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Times one exported process call into the instance's counters, if it has any
+class StretchStatsTimer {
+    StretchStatsState* stats;
+    int64_t inputSamples, outputSamples;
+    std::chrono::steady_clock::time_point start;
+
+    static void add(std::atomic<int64_t>& counter, int64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+public:
+    StretchStatsTimer(StretchStatsState* stats, int64_t inputSamples, int64_t outputSamples) : stats(stats), inputSamples(inputSamples), outputSamples(outputSamples) {
+        if (stats) start = std::chrono::steady_clock::now();
+    }
+
+    // For calls that only know how much input they took once they finish (Stretch_Render)
+    void setInputSamples(int64_t samples) {
+        inputSamples = samples;
+    }
+
+    ~StretchStatsTimer() {
+        if (!stats) return;
+        int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        add(stats->calls, 1);
+        add(stats->inputSamples, inputSamples);
+        add(stats->outputSamples, outputSamples);
+        add(stats->totalNanoseconds, nanoseconds);
+        if (nanoseconds > stats->maxNanoseconds.load(std::memory_order_relaxed)) {
+            stats->maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+        }
+        int64_t budget = stats->budgetNanoseconds.load(std::memory_order_relaxed);
+        if (budget > 0 && nanoseconds > budget) add(stats->overBudget, 1);
+    }
+};
+
+// Parameter snapshot for Stretch_PostParams, applied at block boundaries by Stretch_ProcessParams
+struct StretchParams {
+    float transposeFactor;
+    float tonalityLimit;
+    float formantFactor;
+    float formantBase;
+    int formantCompensatePitch;
+    float rate;         // input samples per output sample, see Stretch_ParamsInputSamples
+    float smoothingMs;  // time constant for gliding to new values, or 0 to jump
+};
+
+// One entry of a Stretch_ProcessBatch call, same interleaved layout as Stretch_Process
+struct ProcessJob {
+    float* input;
+    int inputSamples;
+    float* output;
+    int outputSamples;
 };
 
 struct View
@@ -45,43 +237,1527 @@ public:
     }
 };
 
+// Single-producer single-consumer ring buffer. Capacity is rounded up to a power of two, and positions only
+// ever increase (masked on access), so the producer and consumer each own one atomic.
+template<typename T>
+class SpscFifo {
+    HookVector<T> buffer;
+    size_t mask = 0;
+    std::atomic<size_t> readPos;
+    std::atomic<size_t> writePos;
+
+public:
+    SpscFifo() : readPos(0), writePos(0) {}
+
+    // Not thread-safe: only call while neither side is active
+    void resize(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size *= 2;
+        buffer.assign(size, T());
+        mask = size - 1;
+        readPos = 0;
+        writePos = 0;
+    }
+
+    T& operator[](size_t position) {
+        return buffer[position & mask];
+    }
+
+    size_t capacity() const {
+        return buffer.size();
+    }
+
+    // Producer side
+    size_t writable() const {
+        return buffer.size() - (writePos.load(std::memory_order_relaxed) - readPos.load(std::memory_order_acquire));
+    }
+
+    size_t writeIndex() const {
+        return writePos.load(std::memory_order_relaxed);
+    }
+
+    void commitWrite(size_t count) {
+        writePos.store(writePos.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer side
+    size_t readable() const {
+        return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_relaxed);
+    }
+
+    size_t readIndex() const {
+        return readPos.load(std::memory_order_relaxed);
+    }
+
+    void commitRead(size_t count) {
+        readPos.store(readPos.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+};
+
+enum FreqMapInterpolation { freqMapLinear, freqMapMonotoneCubic };
+
+// Precomputed frequency map for Stretch_SetFreqMapTable / Stretch_SetFreqMapScale. The stretcher calls its map once
+// per bin, so the map is sampled onto a log-frequency grid up front and each call is a single interpolated lookup.
+// Frequencies are normalised (cycles per sample), as the stretcher uses them.
+struct FreqMapTable {
+    static constexpr float minFreq = 1e-4f;
+    static constexpr int stepsPerOctave = 128;
+
+    float logMin;
+    HookVector<float> ratios; // output/input frequency at each grid point
+
+    FreqMapTable() : logMin(std::log2(minFreq)) {
+        int octaves = (int)std::ceil(std::log2(0.5f) - logMin);
+        ratios.assign(octaves * stepsPerOctave + 1, 1.0f);
+    }
+
+    float gridFreq(size_t index) const {
+        return std::exp2(logMin + (float)index / stepsPerOctave);
+    }
+
+    float operator()(float freq) const {
+        if (freq <= minFreq) return freq * ratios[0];
+        float position = (std::log2(freq) - logMin) * stepsPerOctave;
+        size_t index = (size_t)position;
+        if (index + 1 >= ratios.size()) return freq * ratios.back();
+        float fraction = position - index;
+        return freq * (ratios[index] + (ratios[index + 1] - ratios[index]) * fraction);
+    }
+};
+
+// Frequency maps are shared between instances given identical settings (e.g. every voice snapping to the same
+// scale), keyed by the settings themselves. The cache only holds weak references, so the last instance to drop a
+// map frees it. Only touched when a map is set.
+struct FreqMapCache {
+    std::mutex mutex;
+    typedef std::pair<const HookVector<float>, std::weak_ptr<const FreqMapTable>> Entry;
+    std::map<HookVector<float>, std::weak_ptr<const FreqMapTable>, std::less<HookVector<float>>, HookAllocator<Entry>> tables;
+
+    template<class Fill>
+    std::shared_ptr<const FreqMapTable> get(const HookVector<float>& key, Fill&& fill) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<const FreqMapTable> table = tables[key].lock();
+        if (!table) {
+            // separate control block, so the table itself is freed as soon as no instance uses it
+            std::shared_ptr<FreqMapTable> created(hookNew<FreqMapTable>(), hookDelete<FreqMapTable>, HookAllocator<FreqMapTable>());
+            fill(*created);
+            table = created;
+            tables[key] = table;
+        }
+        for (auto it = tables.begin(); it != tables.end();) {
+            it = it->second.expired() ? tables.erase(it) : std::next(it);
+        }
+        return table;
+    }
+
+    size_t bytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        for (auto& entry : tables) {
+            std::shared_ptr<const FreqMapTable> table = entry.second.lock();
+            if (table) total += sizeof(FreqMapTable) + table->ratios.capacity() * sizeof(float);
+        }
+        return total;
+    }
+};
+
+static FreqMapCache freqMapCache;
+
+// At least two points, with finite, positive, strictly increasing inputs (so no segment has zero width and the grid
+// walk in FreqMapTable_FillPoints moves forwards) and finite, non-negative outputs
+static bool FreqMapTable_ValidPoints(const float* inputs, const float* outputs, int points) {
+    if (points < 2) return false;
+    for (int i = 0; i < points; ++i) {
+        if (!(inputs[i] > 0) || !std::isfinite(inputs[i])) return false;
+        if (!(outputs[i] >= 0) || !std::isfinite(outputs[i])) return false;
+        if (i > 0 && !(inputs[i] > inputs[i - 1])) return false;
+    }
+    return true;
+}
+
+// Interpolates through (inputs[i], outputs[i]) points, holding the end ratios beyond the first and last point.
+// The points must pass FreqMapTable_ValidPoints.
+// The monotone cubic uses Fritsch-Carlson tangents, so an increasing set of points gives an increasing map.
+static void FreqMapTable_FillPoints(FreqMapTable& table, const float* inputs, const float* outputs, int points, FreqMapInterpolation interpolation) {
+    HookVector<float> tangents(points, 0.0f);
+    if (interpolation == freqMapMonotoneCubic && points > 2) {
+        HookVector<float> slopes(points - 1);
+        for (int i = 0; i + 1 < points; ++i) {
+            slopes[i] = (outputs[i + 1] - outputs[i]) / (inputs[i + 1] - inputs[i]);
+        }
+        tangents[0] = slopes[0];
+        tangents[points - 1] = slopes[points - 2];
+        for (int i = 1; i + 1 < points; ++i) {
+            tangents[i] = (slopes[i - 1] * slopes[i] <= 0) ? 0 : (slopes[i - 1] + slopes[i]) * 0.5f;
+        }
+        for (int i = 0; i + 1 < points; ++i) {
+            if (slopes[i] == 0) {
+                tangents[i] = tangents[i + 1] = 0;
+                continue;
+            }
+            float a = tangents[i] / slopes[i], b = tangents[i + 1] / slopes[i];
+            float length = a * a + b * b;
+            if (length > 9) {
+                float scale = 3 / std::sqrt(length);
+                tangents[i] = scale * a * slopes[i];
+                tangents[i + 1] = scale * b * slopes[i];
+            }
+        }
+    }
+
+    int segment = 0;
+    for (size_t k = 0; k < table.ratios.size(); ++k) {
+        float freq = table.gridFreq(k);
+        if (freq <= inputs[0]) {
+            table.ratios[k] = outputs[0] / inputs[0];
+            continue;
+        }
+        if (freq >= inputs[points - 1]) {
+            table.ratios[k] = outputs[points - 1] / inputs[points - 1];
+            continue;
+        }
+        while (freq > inputs[segment + 1]) ++segment;
+
+        float width = inputs[segment + 1] - inputs[segment];
+        float t = (freq - inputs[segment]) / width;
+        float mapped;
+        if (interpolation == freqMapMonotoneCubic && points > 2) {
+            float t2 = t * t, t3 = t2 * t;
+            mapped = (2 * t3 - 3 * t2 + 1) * outputs[segment] + (t3 - 2 * t2 + t) * width * tangents[segment]
+                + (-2 * t3 + 3 * t2) * outputs[segment + 1] + (t3 - t2) * width * tangents[segment + 1];
+        } else {
+            mapped = outputs[segment] + (outputs[segment + 1] - outputs[segment]) * t;
+        }
+        table.ratios[k] = mapped / freq;
+    }
+}
+
+// Snaps each (transposed) frequency towards the nearest degree of a repeating-octave scale above `root`.
+// strength 1 snaps fully, 0 leaves the transposed pitch alone, and values between pull part of the way (in cents).
+static void FreqMapTable_FillScale(FreqMapTable& table, float root, const float* degrees, int count, float transposeSemitones, float strength) {
+    HookVector<float> sorted(degrees, degrees + count);
+    for (float& degree : sorted) {
+        degree = std::fmod(std::fmod(degree, 12.0f) + 12.0f, 12.0f);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t k = 0; k < table.ratios.size(); ++k) {
+        float freq = table.gridFreq(k);
+        float semitones = 12 * std::log2(freq / root) + transposeSemitones;
+        float octave = std::floor(semitones / 12);
+        float withinOctave = semitones - octave * 12;
+
+        // nearest degree, including the first degree of the next octave and the last of the previous one
+        float nearest = sorted[0] + 12;
+        for (float degree : sorted) {
+            if (std::abs(degree - withinOctave) < std::abs(nearest - withinOctave)) nearest = degree;
+        }
+        if (std::abs(sorted.back() - 12 - withinOctave) < std::abs(nearest - withinOctave)) nearest = sorted.back() - 12;
+
+        float snapped = semitones + (octave * 12 + nearest - semitones) * strength;
+        table.ratios[k] = std::exp2((snapped - 12 * std::log2(freq / root)) / 12);
+    }
+}
+
+// Wait-free single-writer single-reader mailbox holding the most recent value (a triple buffer).
+// The writer and reader each own one slot, and swap it with the shared middle slot; bit 4 marks it as unread.
+template<typename T>
+class LatestValue {
+    T slots[3];
+    std::atomic<int> middle;
+    int back = 1;   // writer's slot
+    int front = 0;  // reader's slot
+
+public:
+    LatestValue() : middle(2) {}
+
+    void write(const T& value) {
+        slots[back] = value;
+        back = middle.exchange(back | 4, std::memory_order_acq_rel) & 3;
+    }
+
+    // Returns false (leaving `value` alone) if nothing has been written since the last read
+    bool read(T& value) {
+        if (!(middle.load(std::memory_order_relaxed) & 4)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & 3;
+        value = slots[front];
+        return true;
+    }
+};
+
+// Shifts an inputs[c][i]-style accessor along by `offset` samples, to process a block in parts
+template<class Channel>
+struct OffsetChannel {
+    Channel channel;
+    int offset;
+
+    OffsetChannel(Channel channel, int offset) : channel(channel), offset(offset) {}
+
+    auto operator[](int i) -> decltype(channel[i]) {
+        return channel[offset + i];
+    }
+};
+
+template<class Buffer>
+struct OffsetBuffer {
+    Buffer& buffer;
+    int offset;
+
+    OffsetBuffer(Buffer& buffer, int offset) : buffer(buffer), offset(offset) {}
+
+    auto operator[](int c) -> OffsetChannel<typename std::decay<decltype(buffer[c])>::type> {
+        return OffsetChannel<typename std::decay<decltype(buffer[c])>::type>(buffer[c], offset);
+    }
+};
+
+// Quality tiers (Stretch_EnableQualityTiers, Stretch_SetQualityTier, Stretch_SetCpuBudget)
+// Tier 0 is the stretcher as configured. Lower tiers are spare stretchers with the same block but a longer interval,
+// so they analyse fewer frames per second, for 2/3 and 1/2 of the cost at presetDefault's overlap. A tier must have
+// the same total latency as tier 0, or the two outputs would be offset across the crossfade: with split computation
+// the output latency includes one interval, so there the longer interval is paid for with a shorter block, and a tier
+// that still can't match (or would overlap less than 2x) is left out, along with the ones below it. Tiers are only
+// built by Stretch_EnableQualityTiers and the configure calls, never while processing. A switch is spread over
+// blocks so no block does more than two tiers' work: the block that sees the request seeds the incoming tier with
+// the recent input (kept in a ring buffer), then both tiers process until one stretcher block of output has
+// crossfaded between them. Every setter goes to all tiers, so they always sound the same apart from the overlap.
+static const int stretchQualityTiers = 3;
+static const float stretchQualityIntervalScale[stretchQualityTiers] = {1, 1.5f, 2};
+
+struct StretchQuality {
+    signalsmith::stretch::SignalsmithStretch<float>* tiers[stretchQualityTiers] = {}; // [0] is created with the Stretch
+    std::atomic<bool> enabled;
+    std::atomic<int> active;    // written by the thread running the stretcher
+    std::atomic<int> requested; // switched to at the next block boundary
+    float cost[stretchQualityTiers] = {1, 1, 1}; // relative to tier 0
+    int usable = 1; // tiers [0, usable) line up with tier 0; requests for lower ones get the lowest of these
+
+    // Adaptive mode: the processing thread keeps an average of its call times, and steps tiers to fit the budget
+    std::atomic<float> budgetMicroseconds;
+    double averageMicroseconds = 0;
+    int holdCalls = 0; // calls to skip after a switch, while the average settles
+
+    // Recent input, for seeding a tier on the way in
+    int historyFrames = 0;
+    int historyPosition = 0;
+    HookVector<float> history;        // ring, one run of historyFrames per channel
+    HookVector<float> historyLinear;  // unrolled oldest first
+    HookVector<float*> historyChannels;
+    int fadeFrames = 0;               // crossfade length, and the most frames processed per part during one
+    HookVector<float> fade;           // incoming tier's output during a switch
+    HookVector<float*> fadeChannels;
+    int incoming = -1;                // tier seeded for a switch, or -1
+    int fadeDone = 0;                 // frames of the crossfade output so far
+
+    // The last value given to each setter, replayed onto tiers when they are created
+    float transposeFactor = 1, tonalityLimit = 0;
+    float formantFactor = 1, formantBase = 0;
+    bool formantCompensatePitch = false;
+    std::function<float(float)> freqMap;
+
+    StretchQuality() : enabled(false), active(0), requested(0), budgetMicroseconds(0) {}
+};
+
+template<class Set>
+static void StretchQuality_Each(Stretch* stretch, Set&& set) {
+    for (signalsmith::stretch::SignalsmithStretch<float>* tier : stretch->quality->tiers) {
+        if (tier) set(*tier);
+    }
+}
+
+static void StretchQuality_SetTranspose(Stretch* stretch, float factor, float tonalityLimit) {
+    StretchQuality* quality = stretch->quality;
+    quality->transposeFactor = factor;
+    quality->tonalityLimit = tonalityLimit;
+    quality->freqMap = nullptr; // the stretcher drops a custom map when given a transpose factor
+    StretchQuality_Each(stretch, [&](signalsmith::stretch::SignalsmithStretch<float>& tier) {
+        tier.setTransposeFactor(factor, tonalityLimit);
+    });
+}
+
+static void StretchQuality_SetFreqMap(Stretch* stretch, const std::function<float(float)>& freqMap) {
+    stretch->quality->freqMap = freqMap;
+    StretchQuality_Each(stretch, [&](signalsmith::stretch::SignalsmithStretch<float>& tier) {
+        tier.setFreqMap(freqMap);
+    });
+}
+
+static void StretchQuality_SetFormant(Stretch* stretch, float factor, bool compensatePitch) {
+    StretchQuality* quality = stretch->quality;
+    quality->formantFactor = factor;
+    quality->formantCompensatePitch = compensatePitch;
+    StretchQuality_Each(stretch, [&](signalsmith::stretch::SignalsmithStretch<float>& tier) {
+        tier.setFormantFactor(factor, compensatePitch);
+    });
+}
+
+static void StretchQuality_SetFormantBase(Stretch* stretch, float baseFreq) {
+    stretch->quality->formantBase = baseFreq;
+    StretchQuality_Each(stretch, [&](signalsmith::stretch::SignalsmithStretch<float>& tier) {
+        tier.setFormantBase(baseFreq);
+    });
+}
+
+// Makes tier 0 current again, before the stretcher is reconfigured
+static void StretchQuality_Restore(Stretch* stretch) {
+    StretchQuality* quality = stretch->quality;
+    stretch->stretch = quality->tiers[0];
+    quality->active.store(0, std::memory_order_relaxed);
+    quality->incoming = -1;
+}
+
+// Clears every tier's audio state, ending any switch in progress and forgetting the recorded input
+static void StretchQuality_Reset(Stretch* stretch) {
+    StretchQuality* quality = stretch->quality;
+    quality->incoming = -1;
+    quality->fadeDone = 0;
+    StretchQuality_Each(stretch, [](signalsmith::stretch::SignalsmithStretch<float>& tier) {
+        tier.reset();
+    });
+    std::fill(quality->history.begin(), quality->history.end(), 0.0f);
+    quality->historyPosition = 0;
+}
+
+// Configures the lower tiers from tier 0 and sizes the buffers, after a preset or configure call
+static void StretchQuality_Configure(Stretch* stretch) {
+    StretchQuality* quality = stretch->quality;
+    if (!quality->tiers[1]) return;
+
+    signalsmith::stretch::SignalsmithStretch<float>& top = *quality->tiers[0];
+    int channels = stretch->channels;
+    int block = top.blockSamples();
+    int interval = top.intervalSamples();
+    int latency = top.inputLatency() + top.outputLatency();
+    int historyFrames = 0;
+    quality->usable = 1;
+    for (int t = 1; t < stretchQualityTiers; ++t) {
+        signalsmith::stretch::SignalsmithStretch<float>& tier = *quality->tiers[t];
+        if (channels > 0 && block > 0) {
+            int tierInterval = std::max(interval, std::min(block / 2, (int)std::lround(interval * stretchQualityIntervalScale[t])));
+            tier.configure(channels, block, tierInterval, top.splitComputation());
+            int tierBlock = block - (tierInterval - interval);
+            if (tier.inputLatency() + tier.outputLatency() != latency && tierInterval * 2 <= tierBlock) {
+                tier.configure(channels, tierBlock, tierInterval, top.splitComputation());
+            }
+            quality->cost[t] = (float)((double)interval / tierInterval * tier.blockSamples() / block);
+            if (quality->usable == t && tier.inputLatency() + tier.outputLatency() == latency) quality->usable = t + 1;
+        }
+        tier.setTransposeFactor(quality->transposeFactor, quality->tonalityLimit);
+        if (quality->freqMap) tier.setFreqMap(quality->freqMap);
+        tier.setFormantFactor(quality->formantFactor, quality->formantCompensatePitch);
+        tier.setFormantBase(quality->formantBase);
+        historyFrames = std::max(historyFrames, tier.seekLength());
+    }
+    historyFrames = std::max(historyFrames, top.seekLength());
+
+    quality->historyFrames = historyFrames;
+    quality->historyPosition = 0;
+    quality->history.assign((size_t)historyFrames * channels, 0.0f);
+    quality->historyLinear.resize((size_t)historyFrames * channels);
+    quality->historyChannels.resize(channels);
+    for (int c = 0; c < channels; ++c) {
+        quality->historyChannels[c] = quality->historyLinear.data() + (size_t)c * historyFrames;
+    }
+    quality->fadeFrames = std::max(block, 0);
+    quality->fade.assign((size_t)quality->fadeFrames * channels, 0.0f);
+    quality->fadeChannels.resize(channels);
+    for (int c = 0; c < channels; ++c) {
+        quality->fadeChannels[c] = quality->fade.data() + (size_t)c * quality->fadeFrames;
+    }
+}
+
+// Creates and configures the lower tiers. A setup call: like the presets, it must not run alongside processing, so
+// the tiers and their buffers are complete before the processing thread can see them.
+static void StretchQuality_Enable(Stretch* stretch) {
+    StretchQuality* quality = stretch->quality;
+    if (quality->enabled.load(std::memory_order_relaxed)) return;
+    for (int t = 1; t < stretchQualityTiers; ++t) {
+        quality->tiers[t] = hookNew<signalsmith::stretch::SignalsmithStretch<float>>();
+    }
+    StretchQuality_Configure(stretch);
+    Binding_Configured();
+    quality->enabled.store(true, std::memory_order_release);
+}
+
+template<class Inputs>
+static void StretchQuality_Record(StretchQuality* quality, Inputs& inputs, int inputSamples, int channels) {
+    int frames = quality->historyFrames;
+    if (frames <= 0) return;
+    for (int i = std::max(0, inputSamples - frames); i < inputSamples; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            quality->history[(size_t)c * frames + quality->historyPosition] = inputs[c][i];
+        }
+        if (++quality->historyPosition == frames) quality->historyPosition = 0;
+    }
+}
+
+// Seeds `tier` with the recorded input (which must include the block just processed), so from the next block on
+// its output lines up with the active tier's
+static void StretchQuality_Seed(Stretch* stretch, int tier, double playbackRate) {
+    StretchQuality* quality = stretch->quality;
+    int frames = quality->historyFrames;
+    for (int c = 0; c < stretch->channels; ++c) {
+        const float* ring = quality->history.data() + (size_t)c * frames;
+        float* linear = quality->historyChannels[c];
+        std::copy(ring + quality->historyPosition, ring + frames, linear);
+        std::copy(ring, ring + quality->historyPosition, linear + (frames - quality->historyPosition));
+    }
+    signalsmith::stretch::SignalsmithStretch<float>* next = quality->tiers[tier];
+    const float* const* history = quality->historyChannels.data();
+    next->reset();
+    if (frames > 0) next->seek(history, frames, playbackRate);
+    quality->incoming = tier;
+    quality->fadeDone = 0;
+}
+
+// Runs the active tier. A switch to the requested tier takes several blocks: this block seeds the incoming tier after
+// the active one has processed it, and the following blocks run both, in parts no longer than the fade buffer, until
+// fadeFrames of output have crossfaded into the incoming tier.
+template<class Inputs, class Outputs>
+static void StretchQuality_Process(Stretch* stretch, Inputs&& inputs, int inputSamples, Outputs&& outputs, int outputSamples) {
+    StretchQuality* quality = stretch->quality;
+    if (!quality->enabled.load(std::memory_order_acquire)) {
+        stretch->stretch->process(inputs, inputSamples, outputs, outputSamples);
+        return;
+    }
+
+    int channels = stretch->channels;
+    int requested = std::min(quality->requested.load(std::memory_order_relaxed), quality->usable - 1);
+    int active = quality->active.load(std::memory_order_relaxed);
+    if (quality->incoming >= 0 && quality->incoming != requested) quality->incoming = -1; // the request changed mid-switch
+    if (quality->incoming < 0) {
+        stretch->stretch->process(inputs, inputSamples, outputs, outputSamples);
+        StretchQuality_Record(quality, inputs, inputSamples, channels);
+        if (requested != active && inputSamples > 0 && outputSamples > 0) {
+            StretchQuality_Seed(stretch, requested, (double)inputSamples / outputSamples);
+        }
+        return;
+    }
+
+    signalsmith::stretch::SignalsmithStretch<float>* next = quality->tiers[quality->incoming];
+    float* const* fade = quality->fadeChannels.data();
+    int fadeLength = std::max(quality->fadeFrames, 1);
+    int parts = std::max((outputSamples + fadeLength - 1) / fadeLength, 1);
+    const double pi = 3.14159265358979323846;
+    int inputDone = 0, outputDone = 0;
+    for (int part = 1; part <= parts; ++part) {
+        int inputEnd = (int)((long long)inputSamples * part / parts);
+        int outputEnd = (int)((long long)std::max(outputSamples, 0) * part / parts);
+        int length = outputEnd - outputDone;
+        OffsetBuffer<Inputs> partInputs(inputs, inputDone);
+        OffsetBuffer<Outputs> partOutputs(outputs, outputDone);
+        stretch->stretch->process(partInputs, inputEnd - inputDone, partOutputs, length);
+        next->process(partInputs, inputEnd - inputDone, fade, length);
+        for (int i = 0; i < length; ++i) {
+            int position = quality->fadeDone + i;
+            float fadeIn = position < fadeLength ? (float)(0.5 - 0.5 * std::cos(pi * (position + 0.5) / fadeLength)) : 1.0f;
+            for (int c = 0; c < channels; ++c) {
+                float outgoing = partOutputs[c][i];
+                partOutputs[c][i] = outgoing + (fade[c][i] - outgoing) * fadeIn;
+            }
+        }
+        quality->fadeDone += length;
+        inputDone = inputEnd;
+        outputDone = outputEnd;
+    }
+    if (quality->fadeDone >= fadeLength) {
+        stretch->stretch = next;
+        quality->active.store(quality->incoming, std::memory_order_relaxed);
+        quality->incoming = -1;
+    }
+    StretchQuality_Record(quality, inputs, inputSamples, channels);
+}
+
+// Times one block for the adaptive budget. Over 90% of the budget steps down a tier; stepping up waits until the
+// next tier's expected time is under 60%, so it doesn't oscillate between two tiers.
+class StretchQualityTimer {
+    StretchQuality* quality;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    // Not `enabled` on the calling thread of a pipelined instance, since the helper times the blocks it runs
+    StretchQualityTimer(Stretch* stretch, bool enabled = true) : quality(stretch->quality) {
+        if (enabled && quality->budgetMicroseconds.load(std::memory_order_relaxed) > 0) {
+            start = std::chrono::steady_clock::now();
+        } else {
+            quality = nullptr;
+        }
+    }
+
+    ~StretchQualityTimer() {
+        if (!quality) return;
+        double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (quality->holdCalls > 0) {
+            --quality->holdCalls;
+            return;
+        }
+        double& average = quality->averageMicroseconds;
+        average = average > 0 ? average + (microseconds - average) * 0.25 : microseconds;
+
+        float budget = quality->budgetMicroseconds.load(std::memory_order_relaxed);
+        int tier = std::min(quality->requested.load(std::memory_order_relaxed), quality->usable - 1);
+        int target = tier;
+        if (average > budget * 0.9 && tier < quality->usable - 1) {
+            target = tier + 1;
+        } else if (tier > 0 && average * quality->cost[tier - 1] / quality->cost[tier] < budget * 0.6) {
+            target = tier - 1;
+        }
+        if (target != tier) {
+            average *= quality->cost[target] / quality->cost[tier];
+            quality->requested.store(target, std::memory_order_relaxed);
+            quality->holdCalls = 8;
+        }
+    }
+};
+
+struct StretchParamState {
+    LatestValue<StretchParams> mailbox;
+
+    // Owned by the thread running the stretcher (the pipeline helper, if there is one)
+    bool active = false;
+    StretchParams target;
+    StretchParams current;
+    StretchParams applied;
+
+    // The rate decides how much input each block takes, so it is smoothed on the calling thread instead
+    std::atomic<float> targetRate;
+    std::atomic<float> rateSmoothingMs;
+    float currentRate = -1; // negative until the first Stretch_ParamsInputSamples call
+    double inputRemainder = 0;
+
+    StretchParamState() : targetRate(1), rateSmoothingMs(0) {}
+};
+
+// Fraction of the way to move towards a target over `samples`, for a one-pole glide with the given time constant
+static float StretchParams_Glide(float smoothingMs, float sampleRate, int samples) {
+    if (smoothingMs <= 0 || sampleRate <= 0) return 1;
+    return 1 - std::exp(-samples / (smoothingMs * 0.001f * sampleRate));
+}
+
+// Factors glide in the log domain, so an octave up takes as long as an octave down
+static float StretchParams_GlideFactor(float current, float target, float amount) {
+    if (current <= 0 || target <= 0) return target;
+    return current * std::pow(target / current, amount);
+}
+
+static float StretchParams_GlideLinear(float current, float target, float amount) {
+    return current + (target - current) * amount;
+}
+
+static void StretchParams_Apply(Stretch* stretch) {
+    StretchParamState* state = stretch->params;
+    const StretchParams& current = state->current;
+    StretchParams& applied = state->applied;
+
+    if (current.transposeFactor != applied.transposeFactor || current.tonalityLimit != applied.tonalityLimit) {
+        StretchQuality_SetTranspose(stretch, current.transposeFactor, current.tonalityLimit);
+    }
+    if (current.formantFactor != applied.formantFactor || current.formantCompensatePitch != applied.formantCompensatePitch) {
+        StretchQuality_SetFormant(stretch, current.formantFactor, current.formantCompensatePitch != 0);
+    }
+    if (current.formantBase != applied.formantBase) {
+        StretchQuality_SetFormantBase(stretch, current.formantBase);
+    }
+    applied = current;
+}
+
+// Picks up the newest posted snapshot, then processes the block in interval-sized parts, gliding the parameters
+// towards their targets and applying them between parts. Must run on the thread that owns the stretcher.
+template<class Inputs, class Outputs>
+static void StretchParams_Process(Stretch* stretch, Inputs& inputs, int inputSamples, Outputs& outputs, int outputSamples) {
+    StretchParamState* state = stretch->params;
+    StretchParams latest;
+    if (state->mailbox.read(latest)) {
+        state->target = latest;
+        if (!state->active) {
+            state->current = latest;
+            state->applied = latest;
+            state->applied.transposeFactor = -1; // forces every setter on the first Apply
+            state->applied.formantFactor = -1;
+            state->applied.formantBase = -1;
+            state->active = true;
+            StretchParams_Apply(stretch);
+        }
+    }
+    if (!state->active || outputSamples <= 0) {
+        StretchQuality_Process(stretch, inputs, inputSamples, outputs, outputSamples);
+        return;
+    }
+
+    int part = stretch->stretch->intervalSamples();
+    if (part <= 0) part = outputSamples;
+
+    const StretchParams& target = state->target;
+    StretchParams& current = state->current;
+    int inputDone = 0;
+    for (int outputDone = 0; outputDone < outputSamples;) {
+        int outputEnd = std::min(outputDone + part, outputSamples);
+        int inputEnd = (int)((long long)inputSamples * outputEnd / outputSamples);
+
+        float amount = StretchParams_Glide(target.smoothingMs, stretch->sampleRate, outputEnd - outputDone);
+        current.transposeFactor = StretchParams_GlideFactor(current.transposeFactor, target.transposeFactor, amount);
+        current.formantFactor = StretchParams_GlideFactor(current.formantFactor, target.formantFactor, amount);
+        current.formantBase = (current.formantBase > 0 && target.formantBase > 0) ? StretchParams_GlideLinear(current.formantBase, target.formantBase, amount) : target.formantBase;
+        current.tonalityLimit = target.tonalityLimit;
+        current.formantCompensatePitch = target.formantCompensatePitch;
+        StretchParams_Apply(stretch);
+
+        OffsetBuffer<Inputs> partInputs(inputs, inputDone);
+        OffsetBuffer<Outputs> partOutputs(outputs, outputDone);
+        StretchQuality_Process(stretch, partInputs, inputEnd - inputDone, partOutputs, outputEnd - outputDone);
+        inputDone = inputEnd;
+        outputDone = outputEnd;
+    }
+}
+
+// Background processing for one Stretch instance (Stretch_SetPipelined).
+// The calling thread queues each block's input and returns the output of earlier blocks, while a helper thread
+// runs SignalsmithStretch::process. The output is primed with maxBlockSamples of silence, so the helper has a
+// whole callback period to finish each block, at the cost of that much extra output latency.
+// Everything except the helper runs on the producer thread (the one calling Stretch_Process): setters and other
+// calls that touch the stretcher first wait for the helper to go idle (StretchPipeline_Sync), which only ends if
+// nothing else is queuing blocks meanwhile.
+struct StretchPipeline {
+    struct Block {
+        int inputSamples;
+        int outputSamples;
+        bool withParams;
+    };
+
+    static const int maxQueuedBlocks = 8;
+
+    int maxBlockSamples = 0;
+    SpscFifo<float> input;
+    SpscFifo<float> output;
+    SpscFifo<Block> blocks;
+
+    // helper-thread buffers for contiguous process() calls
+    HookVector<float> inputScratch;
+    HookVector<float> outputScratch;
+    HookVector<float*> channelScratch;
+
+    std::thread helper;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<bool> quit;
+    std::atomic<int> pending;
+    std::atomic<int> underruns;
+
+    // Output frames owed by the calling thread: positive means late frames to discard when they arrive,
+    // negative means frames of dropped blocks to replace with silence. Only touched by the calling thread.
+    int debt = 0;
+
+    StretchPipeline() : quit(false), pending(0), underruns(0) {}
+};
+
+// Wakes a thread parked on `wake` from a thread that must not block.
+// The sleeper checks its condition and calls wait() while holding `mutex`, so once we have held the mutex (after
+// publishing the new state) it has either seen that state or is already waiting and will get the notify. The
+// sleeper only holds it for those few instructions, so a short bounded try_lock spin nearly always gets it, but if
+// the sleeper was preempted in between, the notify can be lost. Sleepers therefore wait with a timeout
+// (pipelineWakeInterval), and anything that blocks on them (StretchPipeline_Sync) wakes them with the mutex held.
+static void wakeWaiters(std::mutex& mutex, std::condition_variable& wake) {
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        if (mutex.try_lock()) {
+            mutex.unlock();
+            break;
+        }
+    }
+    wake.notify_all();
+}
+
+// Longest a block can sit queued because of a lost wakeup (see wakeWaiters)
+static const std::chrono::milliseconds pipelineWakeInterval(2);
+
+static void StretchPipeline_Helper(Stretch* stretch) {
+    StretchPipeline* pipeline = stretch->pipeline;
+    int channels = stretch->channels;
+    AllocationScope scope(stretch->allocations);
+
+    while (!pipeline->quit.load()) {
+        if (pipeline->blocks.readable() == 0) {
+            std::unique_lock<std::mutex> lock(pipeline->mutex);
+            while (!pipeline->quit.load() && pipeline->blocks.readable() == 0) {
+                pipeline->wake.wait_for(lock, pipelineWakeInterval);
+            }
+            continue;
+        }
+
+        StretchPipeline::Block block = pipeline->blocks[pipeline->blocks.readIndex()];
+        pipeline->blocks.commitRead(1);
+
+        size_t inputValues = (size_t)block.inputSamples * channels;
+        size_t readIndex = pipeline->input.readIndex();
+        for (size_t i = 0; i < inputValues; ++i) {
+            pipeline->inputScratch[i] = pipeline->input[readIndex + i];
+        }
+        pipeline->input.commitRead(inputValues);
+
+        InterleavedBuffer inBuffer(pipeline->inputScratch.data(), channels);
+        InterleavedBuffer outBuffer(pipeline->outputScratch.data(), channels);
+        {
+            StretchQualityTimer timer(stretch);
+            if (block.withParams) {
+                StretchParams_Process(stretch, inBuffer, block.inputSamples, outBuffer, block.outputSamples);
+            } else {
+                StretchQuality_Process(stretch, inBuffer, block.inputSamples, outBuffer, block.outputSamples);
+            }
+        }
+
+        // The output FIFO is sized for the priming plus every queued block, so this always fits
+        size_t outputValues = (size_t)block.outputSamples * channels;
+        size_t writeIndex = pipeline->output.writeIndex();
+        for (size_t i = 0; i < outputValues; ++i) {
+            pipeline->output[writeIndex + i] = pipeline->outputScratch[i];
+        }
+        pipeline->output.commitWrite(outputValues);
+
+        pipeline->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// Blocks until the helper has finished all queued work, after which the caller may use stretch->stretch directly.
+// Producer thread only: called from another thread while blocks keep arriving, this could spin forever, and the
+// helper could pick up a new block while the caller is still touching the stretcher.
+static void StretchPipeline_Sync(Stretch* stretch) {
+    StretchPipeline* pipeline = stretch->pipeline;
+    if (!pipeline) return;
+    if (pipeline->pending.load(std::memory_order_acquire) > 0) {
+        // This thread may block, so wake the helper properly in case the producer's notify was lost
+        { std::lock_guard<std::mutex> lock(pipeline->mutex); }
+        pipeline->wake.notify_all();
+    }
+    while (pipeline->pending.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+// Discards queued output and re-primes with silence. The helper must be idle (see StretchPipeline_Sync).
+static void StretchPipeline_Restart(Stretch* stretch) {
+    StretchPipeline* pipeline = stretch->pipeline;
+    if (!pipeline) return;
+
+    pipeline->output.commitRead(pipeline->output.readable());
+    size_t primeValues = (size_t)pipeline->maxBlockSamples * stretch->channels;
+    size_t writeIndex = pipeline->output.writeIndex();
+    for (size_t i = 0; i < primeValues; ++i) {
+        pipeline->output[writeIndex + i] = 0;
+    }
+    pipeline->output.commitWrite(primeValues);
+    pipeline->debt = 0;
+}
+
+static void StretchPipeline_Start(Stretch* stretch, int maxBlockSamples) {
+    StretchPipeline* pipeline = hookNew<StretchPipeline>();
+    int channels = stretch->channels;
+    size_t blockValues = (size_t)maxBlockSamples * channels;
+
+    pipeline->maxBlockSamples = maxBlockSamples;
+    pipeline->blocks.resize(StretchPipeline::maxQueuedBlocks);
+    pipeline->input.resize(blockValues * StretchPipeline::maxQueuedBlocks);
+    pipeline->output.resize(blockValues * (StretchPipeline::maxQueuedBlocks + 1));
+    pipeline->inputScratch.resize(blockValues);
+    pipeline->outputScratch.resize(blockValues);
+    pipeline->channelScratch.resize(channels);
+
+    stretch->pipeline = pipeline;
+    StretchPipeline_Restart(stretch);
+    pipeline->helper = std::thread(StretchPipeline_Helper, stretch);
+}
+
+// Returns the block size the pipeline was started with, or 0 if there was none
+static int StretchPipeline_Stop(Stretch* stretch) {
+    StretchPipeline* pipeline = stretch->pipeline;
+    if (!pipeline) return 0;
+
+    StretchPipeline_Sync(stretch);
+    {
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        pipeline->quit = true;
+    }
+    pipeline->wake.notify_all();
+    pipeline->helper.join();
+
+    int maxBlockSamples = pipeline->maxBlockSamples;
+    stretch->pipeline = nullptr;
+    hookDelete(pipeline);
+    return maxBlockSamples;
+}
+
+// Copies queued output (after settling any debt) to the start of `outputs`, returning the number of frames written
+template<class Outputs>
+static int StretchPipeline_Drain(Stretch* stretch, Outputs&& outputs, int outputSamples) {
+    StretchPipeline* pipeline = stretch->pipeline;
+    int channels = stretch->channels;
+
+    int available = (int)(pipeline->output.readable() / channels);
+    if (pipeline->debt > 0) {
+        int discard = std::min(pipeline->debt, available);
+        pipeline->output.commitRead((size_t)discard * channels);
+        pipeline->debt -= discard;
+        available -= discard;
+    }
+
+    int offset = 0;
+    if (pipeline->debt < 0) {
+        offset = std::min(-pipeline->debt, outputSamples);
+        for (int i = 0; i < offset; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                outputs[c][i] = 0;
+            }
+        }
+        pipeline->debt += offset;
+    }
+
+    int frames = std::min(available, outputSamples - offset);
+    size_t readIndex = pipeline->output.readIndex();
+    for (int i = 0; i < frames; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            outputs[c][offset + i] = pipeline->output[readIndex + (size_t)i * channels + c];
+        }
+    }
+    pipeline->output.commitRead((size_t)frames * channels);
+    return offset + frames;
+}
+
+template<class Inputs, class Outputs>
+static void StretchPipeline_Process(Stretch* stretch, Inputs&& inputs, int inputSamples, Outputs&& outputs, int outputSamples, bool withParams) {
+    StretchPipeline* pipeline = stretch->pipeline;
+    int channels = stretch->channels;
+    size_t inputValues = (size_t)inputSamples * channels;
+
+    bool fits = inputSamples <= pipeline->maxBlockSamples && outputSamples <= pipeline->maxBlockSamples;
+    if (fits && pipeline->blocks.writable() > 0 && pipeline->input.writable() >= inputValues) {
+        size_t writeIndex = pipeline->input.writeIndex();
+        for (int i = 0; i < inputSamples; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                pipeline->input[writeIndex + (size_t)i * channels + c] = inputs[c][i];
+            }
+        }
+        pipeline->input.commitWrite(inputValues);
+
+        StretchPipeline::Block& block = pipeline->blocks[pipeline->blocks.writeIndex()];
+        block.inputSamples = inputSamples;
+        block.outputSamples = outputSamples;
+        block.withParams = withParams;
+        pipeline->pending.fetch_add(1, std::memory_order_relaxed);
+        pipeline->blocks.commitWrite(1);
+        wakeWaiters(pipeline->mutex, pipeline->wake);
+    } else {
+        // The helper is too far behind (or the block is too large), so this block's output will never arrive
+        pipeline->underruns.fetch_add(1, std::memory_order_relaxed);
+        pipeline->debt -= outputSamples;
+    }
+
+    int frames = StretchPipeline_Drain(stretch, outputs, outputSamples);
+    if (frames < outputSamples) {
+        for (int i = frames; i < outputSamples; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                outputs[c][i] = 0;
+            }
+        }
+        pipeline->underruns.fetch_add(1, std::memory_order_relaxed);
+        pipeline->debt += outputSamples - frames;
+    }
+}
+
+// One stretcher call, untimed: the exported entry points time the whole call (processBlock, processInterleaved),
+// however many of these it is split into. withParams applies posted parameter snapshots (Stretch_ProcessParams).
+template<class Inputs, class Outputs>
+static void processUntimed(Stretch* stretch, Inputs&& inputs, int inputSamples, Outputs&& outputs, int outputSamples, bool withParams) {
+    if (stretch->pipeline) {
+        StretchPipeline_Process(stretch, inputs, inputSamples, outputs, outputSamples, withParams);
+        return;
+    }
+    if (withParams) {
+        StretchParams_Process(stretch, inputs, inputSamples, outputs, outputSamples);
+    } else {
+        StretchQuality_Process(stretch, inputs, inputSamples, outputs, outputSamples);
+    }
+}
+
+template<class Inputs, class Outputs>
+static void processBlock(Stretch* stretch, Inputs&& inputs, int inputSamples, Outputs&& outputs, int outputSamples, bool withParams = false) {
+    AllocationScope scope(stretch->allocations);
+    StretchStatsTimer timer(stretch->stats, inputSamples, outputSamples);
+    StretchQualityTimer qualityTimer(stretch, !stretch->pipeline);
+    processUntimed(stretch, inputs, inputSamples, outputs, outputSamples, withParams);
+}
+
+// Planar copies of interleaved input and output, so the stretcher reads and writes contiguous channels instead of
+// striding through View. Sized for one stretcher block on configure. Streaming calls longer than that are split into
+// pieces (processInterleaved), so only the offline renderers ever grow it.
+struct StretchScratch {
+    int channels = 0;
+    size_t inputFrames = 0, outputFrames = 0; // per-channel capacity, a multiple of 16 floats
+    HookVector<float> input, output;
+    HookVector<float*> inputChannels, outputChannels;
+};
+
+static void StretchScratch_Prepare(Stretch* stretch, int inputSamples, int outputSamples) {
+    StretchScratch* scratch = stretch->scratch;
+    int channels = stretch->channels;
+    if (scratch->channels != channels) {
+        scratch->channels = channels;
+        scratch->inputFrames = scratch->outputFrames = 0;
+        scratch->inputChannels.resize(channels);
+        scratch->outputChannels.resize(channels);
+    }
+
+    // each channel starts on a 64-byte boundary relative to the buffer
+    if ((size_t)inputSamples > scratch->inputFrames) {
+        scratch->inputFrames = ((size_t)inputSamples + 15) & ~(size_t)15;
+        scratch->input.resize(scratch->inputFrames * channels);
+        for (int c = 0; c < channels; ++c) {
+            scratch->inputChannels[c] = scratch->input.data() + c * scratch->inputFrames;
+        }
+    }
+    if ((size_t)outputSamples > scratch->outputFrames) {
+        scratch->outputFrames = ((size_t)outputSamples + 15) & ~(size_t)15;
+        scratch->output.resize(scratch->outputFrames * channels);
+        for (int c = 0; c < channels; ++c) {
+            scratch->outputChannels[c] = scratch->output.data() + c * scratch->outputFrames;
+        }
+    }
+}
+
+// Interleaved processing in any SampleFormat: deinterleaves (and converts) into the scratch, processes the planar
+// channels, then interleaves the output. Float input to a pipelined instance skips the scratch, because the
+// pipeline copies it anyway. Untimed, like processUntimed.
+static void processInterleavedUntimed(Stretch* stretch, const void* input, SampleFormat format, int inputSamples, float* output, int outputSamples, bool withParams) {
+    int channels = stretch->channels;
+    if (format == sampleFloat32 && (stretch->pipeline || channels == 1)) {
+        InterleavedBuffer inBuffer(const_cast<float*>(static_cast<const float*>(input)), channels);
+        InterleavedBuffer outBuffer(output, channels);
+        processUntimed(stretch, inBuffer, inputSamples, outBuffer, outputSamples, withParams);
+        return;
+    }
+
+    StretchScratch* scratch = stretch->scratch;
+    if (scratch->channels != channels || scratch->inputFrames == 0 || scratch->outputFrames == 0) {
+        StretchScratch_Prepare(stretch, std::max(inputSamples, 1), std::max(outputSamples, 1)); // not configured yet
+    }
+    const float* const* inputs = scratch->inputChannels.data();
+    float* const* outputs = scratch->outputChannels.data();
+
+    // Calls longer than the scratch are split into pieces with the same input:output ratio. Piece boundaries are
+    // computed from absolute positions, so the pieces add up to exactly the requested lengths.
+    unsigned long long inputFrames = std::max(inputSamples, 0), outputFrames = std::max(outputSamples, 0);
+    unsigned long long pieces = std::max((inputFrames + scratch->inputFrames - 1) / scratch->inputFrames, (outputFrames + scratch->outputFrames - 1) / scratch->outputFrames);
+    if (pieces == 0) pieces = 1;
+    const unsigned char* inputBytes = static_cast<const unsigned char*>(input);
+    size_t inputFrameBytes = Binding_SampleBytes(format) * channels;
+    for (unsigned long long piece = 0; piece < pieces; ++piece) {
+        size_t inputStart = (size_t)(inputFrames * piece / pieces), inputEnd = (size_t)(inputFrames * (piece + 1) / pieces);
+        size_t outputStart = (size_t)(outputFrames * piece / pieces), outputEnd = (size_t)(outputFrames * (piece + 1) / pieces);
+        Binding_Deinterleave(inputBytes + inputStart * inputFrameBytes, format, channels, inputEnd - inputStart, scratch->inputChannels.data());
+        processUntimed(stretch, inputs, (int)(inputEnd - inputStart), outputs, (int)(outputEnd - outputStart), withParams);
+        Binding_Interleave(outputs, channels, outputEnd - outputStart, output + outputStart * channels);
+    }
+}
+
+static void processInterleaved(Stretch* stretch, const void* input, SampleFormat format, int inputSamples, float* output, int outputSamples, bool withParams = false) {
+    AllocationScope scope(stretch->allocations);
+    StretchStatsTimer timer(stretch->stats, inputSamples, outputSamples);
+    StretchQualityTimer qualityTimer(stretch, !stretch->pipeline);
+    processInterleavedUntimed(stretch, input, format, inputSamples, output, outputSamples, withParams);
+}
+
+static void processJob(Stretch* stretch, const ProcessJob& job) {
+    processInterleaved(stretch, job.input, sampleFloat32, job.inputSamples, job.output, job.outputSamples);
+}
+
+// Pull-based streaming (Stretch_Render)
+// The time map takes an output frame (counted from Stretch_RenderStart) to an exact input position: piecewise
+// linear between breakpoints, continuing at `rateAfter` past the last one. Every block pulls input up to
+// floor(map(end of block)), computed from absolute positions, so fractional rates never accumulate rounding.
+typedef int (*StretchReadFunction)(void* userData, float* interleaved, int frames);
+
+struct StretchRender {
+    StretchReadFunction read = nullptr;
+    void* userData = nullptr;
+    bool ended = false; // the callback returned short, so the rest of the input is silence
+
+    HookVector<double> mapOutput, mapInput; // breakpoints, output frames strictly increasing
+    double rateAfter = 1;
+    LatestValue<double> postedRate; // from Stretch_SetRenderRate, applied at the start of the next render
+
+    long long outputPosition = 0;
+    long long inputPosition = 0; // input frames pulled so far
+    HookVector<float> input;    // interleaved frames handed to the callback
+};
+
+static double StretchRender_InputAt(const StretchRender* render, double outputFrame) {
+    const HookVector<double>& outputs = render->mapOutput;
+    const HookVector<double>& inputs = render->mapInput;
+    size_t count = outputs.size();
+    size_t after = std::upper_bound(outputs.begin(), outputs.end(), outputFrame) - outputs.begin();
+    if (after == count || count == 1) {
+        return inputs[count - 1] + (outputFrame - outputs[count - 1]) * render->rateAfter;
+    }
+    if (after == 0) after = 1; // before the first breakpoint, extend the first segment
+    double t = (outputFrame - outputs[after - 1]) / (outputs[after] - outputs[after - 1]);
+    return inputs[after - 1] + t * (inputs[after] - inputs[after - 1]);
+}
+
+// Replaces the map with a single breakpoint at the current position, so only the rate changes from here on
+static void StretchRender_Rebase(StretchRender* render, double rate) {
+    double position = StretchRender_InputAt(render, (double)render->outputPosition);
+    render->mapOutput.assign(1, (double)render->outputPosition);
+    render->mapInput.assign(1, position);
+    render->rateAfter = rate;
+}
+
+// Fills `frames` frames of render->input from the callback, zero-padding once the input has ended.
+// `frames` must fit the buffer, which is sized once by Stretch_RenderStart.
+static void StretchRender_Pull(Stretch* stretch, StretchRender* render, int frames) {
+    size_t samples = (size_t)frames * stretch->channels;
+    int got = 0;
+    if (!render->ended && frames > 0) {
+        got = std::max(0, std::min(render->read(render->userData, render->input.data(), frames), frames));
+        if (got < frames) render->ended = true;
+    }
+    std::fill(render->input.begin() + (size_t)got * stretch->channels, render->input.begin() + samples, 0.0f);
+}
+
+// Worker pool for running independent Stretch instances in parallel.
+// Each submitted batch is split into one contiguous range per participant (workers + the thread calling
+// StretchPool_Wait). A participant drains its own range first, then steals from the others. A range's next
+// index and end are packed into one atomic word and every index is claimed with a compare-exchange on it, so no
+// job runs twice even if a worker still scanning the previous batch meets the next one.
+// The submitting side (StretchPool_Submit/StretchPool_Wait) never locks: it publishes the batch with atomics,
+// helps with it, and spins until the workers' last jobs finish. Only idle workers sleep on the condition variable.
+// Nothing allocates once `tasks` has grown to the largest batch size.
+struct StretchPool {
+    struct Task {
+        Stretch* stretch;
+        ProcessJob job;
+    };
+
+    struct Range {
+        std::atomic<uint64_t> state; // next index in the low 32 bits, end in the high 32 bits
+        char padding[64]; // keep ranges on separate cache lines
+    };
+
+    HookVector<std::thread> workers;
+    HookVector<Range> ranges;
+    int rangeCount;
+
+    HookVector<Task> tasks;
+    std::atomic<int> remaining;
+    std::atomic<unsigned> generation;
+    std::atomic<bool> quit;
+
+    // only for parking idle workers
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    StretchPool(int rangeCount) : ranges(rangeCount), rangeCount(rangeCount), remaining(0), generation(0), quit(false) {
+        for (Range& range : ranges) range.state = 0;
+    }
+};
+
+static uint64_t StretchPool_RangeState(int next, int end) {
+    return (uint64_t)(uint32_t)next | ((uint64_t)(uint32_t)end << 32);
+}
+
+static void StretchPool_Run(StretchPool* pool, int self) {
+    for (int r = 0; r < pool->rangeCount; ++r) {
+        StretchPool::Range& range = pool->ranges[(self + r) % pool->rangeCount];
+        uint64_t state = range.state.load(std::memory_order_acquire);
+        while (true) {
+            int index = (int)(uint32_t)state;
+            if (index >= (int)(state >> 32)) break;
+            if (!range.state.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel, std::memory_order_acquire)) continue;
+
+            StretchPool::Task& task = pool->tasks[index];
+            processJob(task.stretch, task.job);
+            pool->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            state = range.state.load(std::memory_order_acquire);
+        }
+    }
+}
+
+static void StretchPool_Worker(StretchPool* pool, int self) {
+    unsigned seen = 0;
+    while (true) {
+        if (pool->generation.load(std::memory_order_acquire) == seen && !pool->quit.load()) {
+            std::unique_lock<std::mutex> lock(pool->mutex);
+            while (!pool->quit.load() && pool->generation.load(std::memory_order_acquire) == seen) {
+                pool->wake.wait(lock);
+            }
+        }
+        if (pool->quit.load()) return;
+        seen = pool->generation.load(std::memory_order_acquire);
+
+        StretchPool_Run(pool, self);
+    }
+}
+
+// Spins (yielding) until every job of the current batch has finished. Only ever waits for jobs already running
+// on a worker, since anything unclaimed is run here first.
+static void StretchPool_WaitIdle(StretchPool* pool) {
+    StretchPool_Run(pool, pool->rangeCount - 1);
+    while (pool->remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+
+// Offline rendering (Stretch_RenderOffline)
+// The output is cut into fixed-length segments, each rendered by its own seeded instance. A segment is pre-rolled
+// with outputSeek() so its first output sample lines up with its start position, and starts crossfadeSamples
+// early so it can be blended over the end of the previous segment. Segment layout and seeds depend only on the
+// input and settings, so the result is identical for any thread count.
+struct OfflineRender {
+    const float* input;
+    long long inputFrames;
+    int channels;
+    float sampleRate;
+    double playbackRate;
+    long long seed;
+    float* output;
+    long long outputFrames;
+
+    int segmentFrames;
+    int crossfadeFrames;
+    int segmentCount;
+    HookVector<float> heads; // the crossfade lead-in of each segment, blended in after all segments finish
+    std::atomic<int> nextSegment;
+};
+
+static long long RenderOffline_InputPosition(const OfflineRender& render, long long outputFrame) {
+    return (long long)std::floor(outputFrame * render.playbackRate + 0.5);
+}
+
+static void RenderOffline_Worker(OfflineRender* render) {
+    int channels = render->channels;
+    HookVector<float> inputWindow;
+    HookVector<float> outputWindow;
+
+    while (true) {
+        int segment = render->nextSegment.fetch_add(1);
+        if (segment >= render->segmentCount) break;
+
+        long long coreStart = (long long)segment * render->segmentFrames;
+        long long coreEnd = std::min(coreStart + render->segmentFrames, render->outputFrames);
+        long long start = segment > 0 ? coreStart - render->crossfadeFrames : 0;
+        int outputLength = (int)(coreEnd - start);
+
+        signalsmith::stretch::SignalsmithStretch<float> stretch((long)(render->seed + segment));
+        stretch.presetDefault(channels, render->sampleRate);
+
+        // Input window from the segment start, zero-padded past the end of the file
+        long long inputStart = RenderOffline_InputPosition(*render, start);
+        int seekLength = stretch.outputSeekLength((float)render->playbackRate);
+        int inputLength = (int)(RenderOffline_InputPosition(*render, coreEnd) - inputStart);
+        inputWindow.assign((size_t)(seekLength + inputLength) * channels, 0.0f);
+        int available = (int)std::max(0LL, std::min((long long)(seekLength + inputLength), render->inputFrames - inputStart));
+        if (available > 0) {
+            std::memcpy(inputWindow.data(), render->input + (size_t)inputStart * channels, (size_t)available * channels * sizeof(float));
+        }
+        outputWindow.resize((size_t)outputLength * channels);
+
+        InterleavedBuffer seekBuffer(inputWindow.data(), channels);
+        stretch.outputSeek(seekBuffer, seekLength);
+        InterleavedBuffer inBuffer(inputWindow.data() + (size_t)seekLength * channels, channels);
+        InterleavedBuffer outBuffer(outputWindow.data(), channels);
+        stretch.process(inBuffer, inputLength, outBuffer, outputLength);
+
+        int headLength = (int)(coreStart - start);
+        std::memcpy(render->heads.data() + (size_t)segment * render->crossfadeFrames * channels, outputWindow.data(), (size_t)headLength * channels * sizeof(float));
+        std::memcpy(render->output + (size_t)coreStart * channels, outputWindow.data() + (size_t)headLength * channels, (size_t)(coreEnd - coreStart) * channels * sizeof(float));
+    }
+}
+
+enum StretchFileFormat { fileFormatWav, fileFormatRawFloat32, fileFormatRawInt16 };
+
+// Stretch_RenderFile maps each file through a window of this many bytes, moving it on as the render advances
+static const size_t renderFileWindowBytes = 8 << 20;
+
+// Deinterleaves `length` frames of sample data from frame `start` into the scratch input (which must be prepared for
+// them), zero-padding past the end of the file. Returns false if the frames can't be mapped.
+static bool RenderFile_Load(Stretch* stretch, MappedFile& input, const WavInfo& info, long long start, int length) {
+    int channels = stretch->channels;
+    float* const* planar = stretch->scratch->inputChannels.data();
+    int available = (int)std::max(0LL, std::min((long long)length, (long long)info.frames - start));
+    if (available > 0) {
+        size_t frameBytes = Binding_SampleBytes(info.format) * channels;
+        const unsigned char* samples = Binding_MapRange(input, info.dataOffset + (unsigned long long)start * frameBytes, (size_t)available * frameBytes, renderFileWindowBytes);
+        if (!samples) return false;
+        Binding_Deinterleave(samples, info.format, channels, available, planar);
+    }
+    for (int c = 0; c < channels; ++c) {
+        std::fill(planar[c] + available, planar[c] + length, 0.0f);
+    }
+    return true;
+}
+
+// Latency-targeted configuration (Stretch_ConfigureForLatency, Stretch_PresetLowLatency)
+// Analysis and synthesis latency come to about half a block each, split computation adds an interval, and a
+// pipeline adds its block. The block starts from that estimate and shrinks until the latency the stretcher reports
+// fits, so the result holds whatever window the library uses.
+static const int latencyMinBlock = 128;
+
+static void StretchLatency_Report(Stretch* stretch, StretchLatencyConfig* config) {
+    int pipelineBlock = stretch->pipeline ? stretch->pipeline->maxBlockSamples : 0;
+    config->blockSamples = stretch->stretch->blockSamples();
+    config->intervalSamples = stretch->stretch->intervalSamples();
+    config->splitComputation = stretch->stretch->splitComputation() ? 1 : 0;
+    config->inputLatency = stretch->stretch->inputLatency();
+    config->outputLatency = stretch->stretch->outputLatency() + pipelineBlock;
+    int latency = config->inputLatency + config->outputLatency;
+    config->latencyMs = stretch->sampleRate > 0 ? latency * 1000.0f / stretch->sampleRate : 0;
+}
+
+static bool StretchLatency_Configure(Stretch* stretch, int nChannels, float sampleRate, float maxLatencyMs, double overlap, bool split, StretchLatencyConfig* chosen) {
+    AllocationScope scope(stretch->allocations);
+    int pipelineBlock = StretchPipeline_Stop(stretch);
+    StretchQuality_Restore(stretch);
+    int limit = (int)std::floor(maxLatencyMs * 0.001 * sampleRate);
+    int available = limit - pipelineBlock;
+    int block = split ? (int)(available * overlap / (overlap + 1)) : available;
+    int latency;
+    while (true) {
+        block = std::max(block, latencyMinBlock);
+        int interval = std::max(1, (int)std::lround(block / overlap));
+        stretch->stretch->configure(nChannels, block, interval, split);
+        latency = stretch->stretch->inputLatency() + stretch->stretch->outputLatency() + pipelineBlock;
+        if (latency <= limit || block == latencyMinBlock) break;
+
+        // shrink in proportion to the overshoot, and by at least one sample
+        int stretchLatency = latency - pipelineBlock;
+        block = (available > 0 && stretchLatency > 0) ? std::min(block - 1, (int)((double)block * available / stretchLatency)) : latencyMinBlock;
+    }
+    stretch->channels = nChannels;
+    stretch->sampleRate = sampleRate;
+    if (pipelineBlock > 0) StretchPipeline_Start(stretch, pipelineBlock);
+    StretchScratch_Prepare(stretch, stretch->stretch->blockSamples(), stretch->stretch->blockSamples());
+    StretchQuality_Configure(stretch);
+    Binding_Configured();
+
+    if (chosen) StretchLatency_Report(stretch, chosen);
+    return latency <= limit;
+}
+
+enum StretchPreset { stretchPresetDefault, stretchPresetCheaper, stretchPresetLowLatency };
+
+// Fixed set of preconfigured instances for voice allocators that start and stop stretchers on the audio thread.
+// Free instances form a lock-free stack of indices; the head packs a change count above the index (plus one,
+// so zero is empty) to rule out ABA on the compare-exchange. Renting and returning never allocate.
+struct StretchInstancePool {
+    HookVector<Stretch*> instances;
+    HookVector<std::atomic<int>> next; // index below each free entry, or -1
+    HookVector<std::atomic<bool>> rented; // so a second Return of the same instance is refused
+    std::atomic<uint64_t> head;
+    std::atomic<int> available;
+
+    StretchInstancePool(int count) : instances(count), next(count), rented(count), head(0), available(0) {}
+};
+
+static void StretchInstancePool_Push(StretchInstancePool* pool, int index) {
+    uint64_t head = pool->head.load(std::memory_order_relaxed);
+    uint64_t updated;
+    do {
+        pool->next[index].store((int)(head & 0xFFFFFFFFu) - 1, std::memory_order_relaxed);
+        updated = ((head >> 32) + 1) << 32 | (uint64_t)(index + 1);
+    } while (!pool->head.compare_exchange_weak(head, updated, std::memory_order_release, std::memory_order_relaxed));
+    pool->available.fetch_add(1, std::memory_order_relaxed);
+}
+
+static int StretchInstancePool_Pop(StretchInstancePool* pool) {
+    uint64_t head = pool->head.load(std::memory_order_acquire);
+    uint64_t updated;
+    int index;
+    do {
+        index = (int)(head & 0xFFFFFFFFu) - 1;
+        if (index < 0) return -1;
+        int below = pool->next[index].load(std::memory_order_relaxed);
+        updated = ((head >> 32) + 1) << 32 | (uint64_t)(below + 1);
+    } while (!pool->head.compare_exchange_weak(head, updated, std::memory_order_acquire, std::memory_order_acquire));
+    pool->available.fetch_sub(1, std::memory_order_relaxed);
+    return index;
+}
+
+// Puts a returned instance back into its just-configured state: cleared buffers and neutral parameters
+static void StretchInstancePool_Recycle(Stretch* stretch) {
+    StretchPipeline_Sync(stretch);
+    StretchQuality* quality = stretch->quality;
+    quality->budgetMicroseconds.store(0);
+    quality->requested.store(0);
+    StretchQuality_Restore(stretch);
+    StretchQuality_Reset(stretch);
+    StretchQuality_SetTranspose(stretch, 1, 0);
+    StretchQuality_SetFormant(stretch, 1, false);
+    StretchQuality_SetFormantBase(stretch, 0);
+
+    StretchParamState* params = stretch->params;
+    StretchParams pending;
+    params->mailbox.read(pending);
+    params->active = false;
+    params->targetRate.store(1);
+    params->rateSmoothingMs.store(0);
+    params->currentRate = -1;
+    params->inputRemainder = 0;
+    if (stretch->stats) stretch->stats->reset();
+    if (stretch->render) stretch->render->read = nullptr;
+    StretchPipeline_Restart(stretch);
+}
+
 extern "C" {
     DLL_EXPORT Stretch* Stretch_Create() {
-        Stretch* s = new Stretch();
-        s->stretch = new signalsmith::stretch::SignalsmithStretch<float>();
+        Stretch* s = hookNew<Stretch>();
+        s->stretch = hookNew<signalsmith::stretch::SignalsmithStretch<float>>();
+        s->params = hookNew<StretchParamState>();
+        if (STRETCH_STATS) s->stats = hookNew<StretchStatsState>();
+        s->scratch = hookNew<StretchScratch>();
+        s->quality = hookNew<StretchQuality>();
+        s->quality->tiers[0] = s->stretch;
         return s;
     }
 
     DLL_EXPORT Stretch* Stretch_CreateSeed(long seed) {
-        Stretch* s = new Stretch();
-        s->stretch = new signalsmith::stretch::SignalsmithStretch<float>(seed);
+        Stretch* s = hookNew<Stretch>();
+        s->stretch = hookNew<signalsmith::stretch::SignalsmithStretch<float>>(seed);
+        s->params = hookNew<StretchParamState>();
+        if (STRETCH_STATS) s->stats = hookNew<StretchStatsState>();
+        s->scratch = hookNew<StretchScratch>();
+        s->quality = hookNew<StretchQuality>();
+        s->quality->tiers[0] = s->stretch;
         return s;
     }
 
     DLL_EXPORT void Stretch_Release(Stretch* stretch) {
-        delete stretch->stretch;
-        memset(stretch, 0xFF, sizeof(Stretch));
-        delete stretch;
+        StretchPipeline_Stop(stretch);
+        for (signalsmith::stretch::SignalsmithStretch<float>* tier : stretch->quality->tiers) {
+            hookDelete(tier);
+        }
+        hookDelete(stretch->quality);
+        hookDelete(stretch->params);
+        hookDelete(stretch->stats);
+        hookDelete(stretch->scratch);
+        hookDelete(stretch->render);
+        memset(static_cast<void*>(stretch), 0xFF, sizeof(Stretch));
+        hookDelete(stretch);
     }
 
     DLL_EXPORT void Stretch_PresetDefault(Stretch* stretch, int nChannels, float sampleRate, bool splitComputation) {
+        AllocationScope scope(stretch->allocations);
+        int pipelineBlock = StretchPipeline_Stop(stretch);
+        StretchQuality_Restore(stretch);
         stretch->stretch->presetDefault(nChannels, sampleRate, splitComputation);
         stretch->channels = nChannels;
         stretch->sampleRate = sampleRate;
+        if (pipelineBlock > 0) StretchPipeline_Start(stretch, pipelineBlock);
+        StretchScratch_Prepare(stretch, stretch->stretch->blockSamples(), stretch->stretch->blockSamples());
+        StretchQuality_Configure(stretch);
+        Binding_Configured();
     }
 
     DLL_EXPORT void Stretch_PresetCheaper(Stretch* stretch, int nChannels, float sampleRate, bool splitComputation) {
+        AllocationScope scope(stretch->allocations);
+        int pipelineBlock = StretchPipeline_Stop(stretch);
+        StretchQuality_Restore(stretch);
         stretch->stretch->presetCheaper(nChannels, sampleRate, splitComputation);
         stretch->channels = nChannels;
         stretch->sampleRate = sampleRate;
+        if (pipelineBlock > 0) StretchPipeline_Start(stretch, pipelineBlock);
+        StretchScratch_Prepare(stretch, stretch->stretch->blockSamples(), stretch->stretch->blockSamples());
+        StretchQuality_Configure(stretch);
+        Binding_Configured();
     }
 
     DLL_EXPORT void Stretch_Configure(Stretch* stretch, int nChannels, int blockSamples, int intervalSamples, bool splitComputation) {
+        AllocationScope scope(stretch->allocations);
+        int pipelineBlock = StretchPipeline_Stop(stretch);
+        StretchQuality_Restore(stretch);
         stretch->stretch->configure(nChannels, blockSamples, intervalSamples, splitComputation);
+        stretch->channels = nChannels;
+        if (pipelineBlock > 0) StretchPipeline_Start(stretch, pipelineBlock);
+        StretchScratch_Prepare(stretch, stretch->stretch->blockSamples(), stretch->stretch->blockSamples());
+        StretchQuality_Configure(stretch);
+        Binding_Configured();
+    }
+
+    // Picks block and interval sizes so that input plus output latency fits in maxLatencyMs. cpuBudget sets how much
+    // the blocks overlap: 0 like presetCheaper, 1 like presetDefault, and more above that (up to 8x overlap). Below
+    // 1 it also turns on split computation, which evens out the cost per call at the price of one interval of
+    // latency. Fills `chosen` if it isn't null, and returns false if even a 128-sample block doesn't fit.
+    DLL_EXPORT bool Stretch_ConfigureForLatency(Stretch* stretch, int nChannels, float sampleRate, float maxLatencyMs, float cpuBudget, StretchLatencyConfig* chosen) {
+        double overlap = std::min(std::max(2.5 + 1.5 * cpuBudget, 2.5), 8.0);
+        return StretchLatency_Configure(stretch, nChannels, sampleRate, maxLatencyMs, overlap, cpuBudget < 1, chosen);
+    }
+
+    // Under 20ms round trip (input plus output latency) with presetDefault's overlap, for live monitoring. The short
+    // blocks give up frequency resolution, so low notes smear more than with the other presets.
+    DLL_EXPORT void Stretch_PresetLowLatency(Stretch* stretch, int nChannels, float sampleRate, bool splitComputation) {
+        StretchLatency_Configure(stretch, nChannels, sampleRate, 20, 4, splitComputation, nullptr);
+    }
+
+    // The block, interval and latency of the current configuration, whichever preset or configure call set it
+    DLL_EXPORT void Stretch_GetLatencyConfig(Stretch* stretch, StretchLatencyConfig* config) {
+        StretchLatency_Report(stretch, config);
+    }
+
+    // Routes the binding's own allocations (Stretch, FFT and STFT wrappers, and their buffers) through
+    // `alloc` and `free`. Blocks must be aligned for any type (16 bytes is enough on common platforms). Pass null
+    // to go back to malloc/free. Not thread-safe: set it while no other thread is creating or configuring
+    // instances. Buffers allocated inside the stretcher and FFT libraries themselves still use the default heap.
+    DLL_EXPORT void Stretch_SetAllocator(StretchAllocFunction alloc, StretchFreeFunction free, void* userData) {
+        allocationHooks.alloc = (alloc && free) ? alloc : nullptr;
+        allocationHooks.free = (alloc && free) ? free : nullptr;
+        allocationHooks.userData = userData;
+    }
+
+    // Total allocations made through the binding's allocator since the library was loaded
+    DLL_EXPORT size_t Stretch_AllocationCount() {
+        return allocationCount.load(std::memory_order_relaxed);
+    }
+
+    // Allocations made through the binding's allocator on behalf of this instance (on any thread, including the
+    // pipeline helper) since its most recent configure, preset, Stretch_SetPipelined or Stretch_RenderStart call.
+    // Nonzero after setup means something is allocating while processing.
+    DLL_EXPORT size_t Stretch_AllocationsSinceConfigure(Stretch* stretch) {
+        return stretch->allocations.load(std::memory_order_relaxed);
     }
 
     DLL_EXPORT void Stretch_Reset(Stretch* stretch) {
-        stretch->stretch->reset();
+        StretchPipeline_Sync(stretch);
+        StretchQuality_Reset(stretch);
+        StretchPipeline_Restart(stretch);
+    }
+
+    // Heap bytes held by the binding for this instance. Frequency maps shared between instances are counted once by
+    // Stretch_SharedMemoryFootprint. The stretcher's own STFT, FFT and analysis buffers are allocated inside
+    // signalsmith-stretch through the standard allocator, so they are not included.
+    DLL_EXPORT size_t Stretch_MemoryFootprint(Stretch* stretch) {
+        size_t bytes = sizeof(Stretch) + sizeof(StretchParamState) + sizeof(StretchQuality);
+        StretchQuality* quality = stretch->quality;
+        for (signalsmith::stretch::SignalsmithStretch<float>* tier : quality->tiers) {
+            if (tier) bytes += sizeof(signalsmith::stretch::SignalsmithStretch<float>);
+        }
+        bytes += (quality->history.capacity() + quality->historyLinear.capacity() + quality->fade.capacity()) * sizeof(float);
+        bytes += (quality->historyChannels.capacity() + quality->fadeChannels.capacity()) * sizeof(float*);
+        StretchScratch* scratch = stretch->scratch;
+        bytes += sizeof(StretchScratch) + (scratch->input.capacity() + scratch->output.capacity()) * sizeof(float);
+        bytes += (scratch->inputChannels.capacity() + scratch->outputChannels.capacity()) * sizeof(float*);
+        StretchPipeline* pipeline = stretch->pipeline;
+        if (pipeline) {
+            bytes += sizeof(StretchPipeline);
+            bytes += (pipeline->input.capacity() + pipeline->output.capacity()) * sizeof(float);
+            bytes += pipeline->blocks.capacity() * sizeof(StretchPipeline::Block);
+            bytes += (pipeline->inputScratch.capacity() + pipeline->outputScratch.capacity()) * sizeof(float);
+            bytes += pipeline->channelScratch.capacity() * sizeof(float*);
+        }
+        StretchRender* render = stretch->render;
+        if (render) {
+            bytes += sizeof(StretchRender) + render->input.capacity() * sizeof(float);
+            bytes += (render->mapOutput.capacity() + render->mapInput.capacity()) * sizeof(double);
+        }
+        return bytes;
+    }
+
+    DLL_EXPORT size_t Stretch_SharedMemoryFootprint() {
+        return freqMapCache.bytes();
     }
 
     DLL_EXPORT int Stretch_InputLatency(Stretch* stretch) {
@@ -89,7 +1765,9 @@ extern "C" {
     }
 
     DLL_EXPORT int Stretch_OutputLatency(Stretch* stretch) {
-        return stretch->stretch->outputLatency();
+        int latency = stretch->stretch->outputLatency();
+        if (stretch->pipeline) latency += stretch->pipeline->maxBlockSamples;
+        return latency;
     }
 
     DLL_EXPORT int Stretch_BlockSamples(Stretch* stretch) {
@@ -105,37 +1783,103 @@ extern "C" {
     }
 
     DLL_EXPORT void Stretch_SetTransposeSemitones(Stretch* stretch, float semitones, float tonalityLimit) {
-        stretch->stretch->setTransposeSemitones(semitones, tonalityLimit);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetTranspose(stretch, std::pow(2.0f, semitones / 12), tonalityLimit);
     }
 
     DLL_EXPORT void Stretch_SetTransposeFactor(Stretch* stretch, float factor, float tonalityLimit) {
-        stretch->stretch->setTransposeFactor(factor, tonalityLimit);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetTranspose(stretch, factor, tonalityLimit);
     }
 
     DLL_EXPORT void Stretch_SetFreqMap(Stretch* stretch, float (*inputToOutput)(float)) {
-        stretch->stretch->setFreqMap(inputToOutput);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetFreqMap(stretch, inputToOutput);
+    }
+
+    // Piecewise frequency map through `points` (input Hz, output Hz) pairs, sorted by input frequency.
+    // interpolation is 0 for linear or 1 for monotone cubic. If no sample rate was set by a preset, the
+    // frequencies are taken as normalised (cycles per sample) instead of Hz.
+    // Returns false, leaving the current map in place, unless there are at least two points, the input frequencies
+    // are positive and strictly increasing, and the output frequencies are not negative.
+    DLL_EXPORT bool Stretch_SetFreqMapTable(Stretch* stretch, const float* inputFreqs, const float* outputFreqs, int points, int interpolation) {
+        AllocationScope scope(stretch->allocations);
+        if (points < 2 || (interpolation != freqMapLinear && interpolation != freqMapMonotoneCubic)) return false;
+        float scale = stretch->sampleRate > 0 ? 1 / stretch->sampleRate : 1;
+        // key: interpolation, then the normalised inputs and outputs
+        HookVector<float> key(1 + 2 * points);
+        key[0] = (float)interpolation;
+        float* inputs = key.data() + 1;
+        float* outputs = inputs + points;
+        for (int i = 0; i < points; ++i) {
+            inputs[i] = inputFreqs[i] * scale;
+            outputs[i] = outputFreqs[i] * scale;
+        }
+        if (!FreqMapTable_ValidPoints(inputs, outputs, points)) return false;
+
+        std::shared_ptr<const FreqMapTable> table = freqMapCache.get(key, [&](FreqMapTable& fill) {
+            FreqMapTable_FillPoints(fill, inputs, outputs, points, (FreqMapInterpolation)interpolation);
+        });
+
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetFreqMap(stretch, [table](float freq) { return (*table)(freq); });
+        return true;
+    }
+
+    // Snap-to-scale map: `degrees` are semitone offsets above `rootHz` (repeating every octave), pitches are first
+    // shifted by transposeSemitones, and strength (0-1) sets how far they are pulled onto the nearest degree.
+    DLL_EXPORT void Stretch_SetFreqMapScale(Stretch* stretch, float rootHz, const float* degrees, int count, float transposeSemitones, float strength) {
+        AllocationScope scope(stretch->allocations);
+        if (count < 1 || !(rootHz > 0)) return;
+        float root = stretch->sampleRate > 0 ? rootHz / stretch->sampleRate : rootHz;
+        strength = std::min(std::max(strength, 0.0f), 1.0f);
+
+        // key: -1 (never a valid interpolation), root, transpose, strength, then the degrees
+        HookVector<float> key = {-1.0f, root, transposeSemitones, strength};
+        key.insert(key.end(), degrees, degrees + count);
+
+        std::shared_ptr<const FreqMapTable> table = freqMapCache.get(key, [&](FreqMapTable& fill) {
+            FreqMapTable_FillScale(fill, root, degrees, count, transposeSemitones, strength);
+        });
+
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetFreqMap(stretch, [table](float freq) { return (*table)(freq); });
     }
 
     DLL_EXPORT void Stretch_SetFormantFactor(Stretch* stretch, float multiplier, bool compensatePitch) {
-        stretch->stretch->setFormantFactor(multiplier, compensatePitch);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetFormant(stretch, multiplier, compensatePitch);
     }
 
     DLL_EXPORT void Stretch_SetFormantSemitones(Stretch* stretch, float semitones, bool compensatePitch) {
-        stretch->stretch->setFormantSemitones(semitones, compensatePitch);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetFormant(stretch, std::pow(2.0f, semitones / 12), compensatePitch);
     }
 
     DLL_EXPORT void Stretch_SetFormantBase(Stretch* stretch, float baseFreq) {
-        stretch->stretch->setFormantBase(baseFreq);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_SetFormantBase(stretch, baseFreq);
     }
 
     DLL_EXPORT void Stretch_Seek(Stretch* stretch, float* input, int inputSamples, double playbackRate) {
+        StretchPipeline_Sync(stretch);
         InterleavedBuffer inBuffer(input, stretch->channels);
         stretch->stretch->seek(inBuffer, inputSamples, playbackRate);
+        StretchPipeline_Restart(stretch);
     }
 
     DLL_EXPORT void Stretch_Flush(Stretch* stretch, float* output, int pcmOutLength, double playbackRate) {
-        InterleavedBuffer outBuffer(output, stretch->channels);
-        stretch->stretch->flush(outBuffer, pcmOutLength, playbackRate);
+        int queued = 0;
+        if (stretch->pipeline) {
+            // Output still in the pipeline comes before the flushed tail
+            StretchPipeline_Sync(stretch);
+            InterleavedBuffer queuedBuffer(output, stretch->channels);
+            queued = StretchPipeline_Drain(stretch, queuedBuffer, pcmOutLength);
+        }
+
+        InterleavedBuffer outBuffer(output + (size_t)queued * stretch->channels, stretch->channels);
+        stretch->stretch->flush(outBuffer, pcmOutLength - queued, playbackRate);
+        StretchPipeline_Restart(stretch);
     }
 
     DLL_EXPORT int Stretch_SeekLength(Stretch* stretch) {
@@ -143,8 +1887,10 @@ extern "C" {
     }
 
     DLL_EXPORT void Stretch_OutputSeek(Stretch* stretch, float* input, int inputLength) {
+        StretchPipeline_Sync(stretch);
         InterleavedBuffer inBuffer(input, stretch->channels);
         stretch->stretch->outputSeek(inBuffer, inputLength);
+        StretchPipeline_Restart(stretch);
     }
 
     DLL_EXPORT int Stretch_OutputSeekLength(Stretch* stretch, float playbackRate) {
@@ -152,14 +1898,596 @@ extern "C" {
     }
 
     DLL_EXPORT void Stretch_Process(Stretch* stretch, float* input, int pcmLength, float* output, int pcmOutLength) {
-        InterleavedBuffer inBuffer(input, stretch->channels);
-        InterleavedBuffer outBuffer(output, stretch->channels);
-        stretch->stretch->process(inBuffer, pcmLength, outBuffer, pcmOutLength);
+        processInterleaved(stretch, input, sampleFloat32, pcmLength, output, pcmOutLength);
+    }
+
+    // Stretch_Process with interleaved input in another SampleFormat (0 float, 1 int16, 2 packed int24, 3 int32),
+    // converted while deinterleaving. Output is interleaved float.
+    DLL_EXPORT void Stretch_ProcessFormat(Stretch* stretch, const void* input, int format, int pcmLength, float* output, int pcmOutLength) {
+        processInterleaved(stretch, input, (SampleFormat)format, pcmLength, output, pcmOutLength);
+    }
+
+    // Publishes a parameter snapshot without blocking. Safe to call from one control thread while another thread
+    // is processing; the values take effect (gliding over params->smoothingMs) in the next Stretch_ProcessParams.
+    DLL_EXPORT void Stretch_PostParams(Stretch* stretch, const StretchParams* params) {
+        stretch->params->targetRate.store(params->rate, std::memory_order_relaxed);
+        stretch->params->rateSmoothingMs.store(params->smoothingMs, std::memory_order_relaxed);
+        stretch->params->mailbox.write(*params);
+    }
+
+    // Stretch_Process, but first applies the latest posted snapshot, gliding parameters across the block
+    DLL_EXPORT void Stretch_ProcessParams(Stretch* stretch, float* input, int pcmLength, float* output, int pcmOutLength) {
+        processInterleaved(stretch, input, sampleFloat32, pcmLength, output, pcmOutLength, true);
+    }
+
+    DLL_EXPORT void Stretch_ProcessParamsPlanar(Stretch* stretch, const float* const* input, int pcmLength, float* const* output, int pcmOutLength) {
+        processBlock(stretch, input, pcmLength, output, pcmOutLength, true);
+    }
+
+    // Input length for the next block of `outputSamples`, following the posted rate with the same smoothing.
+    // Call once per block from the processing thread, and pass the result to Stretch_ProcessParams.
+    DLL_EXPORT int Stretch_ParamsInputSamples(Stretch* stretch, int outputSamples) {
+        StretchParamState* state = stretch->params;
+        float target = state->targetRate.load(std::memory_order_relaxed);
+        float previous = state->currentRate < 0 ? target : state->currentRate;
+        float amount = StretchParams_Glide(state->rateSmoothingMs.load(std::memory_order_relaxed), stretch->sampleRate, outputSamples);
+        state->currentRate = StretchParams_GlideFactor(previous, target, amount);
+
+        double exact = state->inputRemainder + outputSamples * 0.5 * (previous + state->currentRate);
+        int inputSamples = (int)std::floor(exact);
+        state->inputRemainder = exact - inputSamples;
+        return inputSamples;
+    }
+
+    // Starts pull-based streaming: each Stretch_Render call asks `read` for exactly the interleaved input it needs
+    // (returning fewer frames than requested ends the input, and silence is fed from then on). Positions restart
+    // from zero, at a rate of 1 unless Stretch_SetRenderRate was called since the previous start. Does not clear
+    // the stretcher, so call Stretch_Reset first for an unrelated stream.
+    DLL_EXPORT void Stretch_RenderStart(Stretch* stretch, StretchReadFunction read, void* userData) {
+        AllocationScope scope(stretch->allocations);
+        if (!stretch->render) stretch->render = hookNew<StretchRender>();
+        StretchRender* render = stretch->render;
+        render->read = read;
+        render->userData = userData;
+        render->ended = false;
+        render->outputPosition = 0;
+        render->inputPosition = 0;
+        double rate = 1;
+        render->postedRate.read(rate); // keeps a rate set before starting
+        render->mapOutput.assign(1, 0.0);
+        render->mapInput.assign(1, 0.0);
+        render->rateAfter = rate;
+
+        // Room for a full stretcher block of input. Stretch_Render feeds sub-blocks that need more than this (at high
+        // rates, or across a jump in the time map) in pieces, so rendering never grows it.
+        size_t frames = (size_t)std::max(std::max(stretch->stretch->blockSamples(), stretch->stretch->intervalSamples()), 1);
+        if (render->input.size() < frames * stretch->channels) render->input.resize(frames * stretch->channels);
+        Binding_Configured();
+    }
+
+    // Input frames per output frame from the start of the next Stretch_Render. Wait-free, so a control thread can
+    // call it while another thread renders. Replaces any time map. Does nothing before the first Stretch_RenderStart.
+    DLL_EXPORT void Stretch_SetRenderRate(Stretch* stretch, double rate) {
+        if (!stretch->render) return;
+        stretch->render->postedRate.write(std::max(rate, 0.0));
+    }
+
+    // Replaces the time map with `points` breakpoints from output frame to input frame, both counted from
+    // Stretch_RenderStart, with output frames increasing. Between breakpoints the rate is the slope of the segment,
+    // and after the last one it is `rateAfter`. Call from the rendering thread (it allocates if the map grows).
+    DLL_EXPORT void Stretch_SetRenderTimeMap(Stretch* stretch, const double* outputFrames, const double* inputFrames, int points, double rateAfter) {
+        AllocationScope scope(stretch->allocations);
+        if (!stretch->render) return;
+        StretchRender* render = stretch->render;
+        double pending;
+        render->postedRate.read(pending); // an older Stretch_SetRenderRate must not override the map
+        if (points <= 0) {
+            StretchRender_Rebase(render, std::max(rateAfter, 0.0));
+            return;
+        }
+        render->mapOutput.clear();
+        render->mapInput.clear();
+        for (int i = 0; i < points; ++i) {
+            if (i > 0 && !(outputFrames[i] > render->mapOutput.back())) continue;
+            render->mapOutput.push_back(outputFrames[i]);
+            render->mapInput.push_back(inputFrames[i]);
+        }
+        render->rateAfter = std::max(rateAfter, 0.0);
+    }
+
+    // Renders `frames` interleaved output frames, pulling input through the Stretch_RenderStart callback. Blocks are
+    // split at the stretcher interval and at every breakpoint, so rate changes land on the exact output frame.
+    // Posted parameter snapshots (Stretch_PostParams) apply as in Stretch_ProcessParams, except their rate.
+    // Returns the number of input frames pulled.
+    DLL_EXPORT int Stretch_Render(Stretch* stretch, float* output, int frames) {
+        AllocationScope scope(stretch->allocations);
+        StretchRender* render = stretch->render;
+        // (a configure with more channels needs a new Stretch_RenderStart, which sizes the input buffer for them)
+        if (!render || !render->read || render->input.size() < (size_t)stretch->channels) {
+            std::fill(output, output + (size_t)std::max(frames, 0) * stretch->channels, 0.0f);
+            return 0;
+        }
+        StretchStatsTimer timer(stretch->stats, 0, std::max(frames, 0));
+        StretchQualityTimer qualityTimer(stretch, !stretch->pipeline);
+        double rate;
+        if (render->postedRate.read(rate)) StretchRender_Rebase(render, rate);
+
+        int part = stretch->stretch->intervalSamples();
+        if (part <= 0) part = std::max(frames, 1);
+        long long pulled = 0;
+        for (int done = 0; done < frames;) {
+            long long start = render->outputPosition;
+            int length = std::min(part, frames - done);
+            size_t next = std::upper_bound(render->mapOutput.begin(), render->mapOutput.end(), (double)start) - render->mapOutput.begin();
+            if (next < render->mapOutput.size()) {
+                long long breakpoint = (long long)std::ceil(render->mapOutput[next]);
+                if (breakpoint > start && breakpoint < start + length) length = (int)(breakpoint - start);
+            }
+
+            long long inputEnd = (long long)std::floor(StretchRender_InputAt(render, (double)(start + length)));
+            long long inputSamples = std::max(0LL, inputEnd - render->inputPosition);
+            // Input beyond the buffer is pulled and processed in pieces, with the output split in proportion
+            long long capacity = (long long)(render->input.size() / stretch->channels);
+            long long pieces = std::max(1LL, (inputSamples + capacity - 1) / capacity);
+            for (long long piece = 0; piece < pieces; ++piece) {
+                int pieceInput = (int)(inputSamples * (piece + 1) / pieces - inputSamples * piece / pieces);
+                int outputStart = (int)(length * piece / pieces), outputEnd = (int)(length * (piece + 1) / pieces);
+                StretchRender_Pull(stretch, render, pieceInput);
+                processInterleavedUntimed(stretch, render->input.data(), sampleFloat32, pieceInput, output + (size_t)(done + outputStart) * stretch->channels, outputEnd - outputStart, true);
+            }
+
+            render->inputPosition += inputSamples;
+            render->outputPosition += length;
+            pulled += inputSamples;
+            done += length;
+        }
+        timer.setInputSamples(pulled);
+        return (int)pulled;
+    }
+
+    // Exact input position (in frames, possibly fractional) reached by the output rendered so far
+    DLL_EXPORT double Stretch_RenderInputPosition(Stretch* stretch) {
+        StretchRender* render = stretch->render;
+        if (!render) return 0;
+        return StretchRender_InputAt(render, (double)render->outputPosition);
+    }
+
+    // Fills `stats` with the counters since creation (or the last Stretch_ResetStats). Returns false, leaving
+    // everything zero, if the library was built without STRETCH_STATS. Process calls are timed as seen by the
+    // caller, so for pipelined instances this is the hand-off time rather than the background processing.
+    DLL_EXPORT bool Stretch_GetStats(Stretch* stretch, StretchStats* stats) {
+        std::memset(stats, 0, sizeof(StretchStats));
+        StretchStatsState* state = stretch->stats;
+        if (!state) return false;
+
+        stats->calls = state->calls.load(std::memory_order_relaxed);
+        stats->inputSamples = state->inputSamples.load(std::memory_order_relaxed);
+        stats->outputSamples = state->outputSamples.load(std::memory_order_relaxed);
+        stats->overBudget = state->overBudget.load(std::memory_order_relaxed);
+        stats->totalMicroseconds = state->totalNanoseconds.load(std::memory_order_relaxed) * 1e-3;
+        stats->maxMicroseconds = state->maxNanoseconds.load(std::memory_order_relaxed) * 1e-3;
+        stats->budgetMicroseconds = state->budgetNanoseconds.load(std::memory_order_relaxed) * 1e-3;
+        return true;
+    }
+
+    DLL_EXPORT void Stretch_ResetStats(Stretch* stretch) {
+        if (stretch->stats) stretch->stats->reset();
+    }
+
+    // Process calls longer than this are counted in StretchStats::overBudget (0 turns the check off)
+    DLL_EXPORT void Stretch_SetStatsBudget(Stretch* stretch, double microseconds) {
+        if (stretch->stats) stretch->stats->budgetNanoseconds.store((int64_t)(std::max(microseconds, 0.0) * 1e3), std::memory_order_relaxed);
+    }
+
+    // Builds the spare quality tiers, so Stretch_SetQualityTier and Stretch_SetCpuBudget can switch between them.
+    // A setup call like the presets (it allocates, and waits for a pipelined instance to go idle). Later configure
+    // and preset calls rebuild the tiers to match.
+    DLL_EXPORT void Stretch_EnableQualityTiers(Stretch* stretch) {
+        AllocationScope scope(stretch->allocations);
+        StretchPipeline_Sync(stretch);
+        StretchQuality_Enable(stretch);
+        StretchPipeline_Restart(stretch);
+    }
+
+    // Requests quality tier 0 (as configured), 1 or 2 (about 2/3 and 1/2 of the cost). Real-time safe from any thread;
+    // has no effect until Stretch_EnableQualityTiers. The next block seeds the incoming tier, and the blocks after it
+    // crossfade over one stretcher block of output. Lower tiers use a longer interval, so once the switch completes
+    // Stretch_IntervalSamples changes; with split computation Stretch_BlockSamples shrinks to keep the total latency
+    // the same, and a tier that can't keep it isn't available (the lowest available one is used instead).
+    // While a CPU budget is set, the adaptive mode overrides this.
+    DLL_EXPORT void Stretch_SetQualityTier(Stretch* stretch, int tier) {
+        stretch->quality->requested.store(std::min(std::max(tier, 0), stretchQualityTiers - 1), std::memory_order_relaxed);
+    }
+
+    // The tier doing the processing
+    DLL_EXPORT int Stretch_GetQualityTier(Stretch* stretch) {
+        return stretch->quality->active.load(std::memory_order_relaxed);
+    }
+
+    // Picks the tier adaptively so each process call fits in microsecondsPerBlock: a tier down when calls average
+    // over 90% of the budget, and back up once the better tier would take under 60%. Pipelined instances time the
+    // background processing. 0 turns it off, staying on the current tier. Real-time safe; switches only once
+    // Stretch_EnableQualityTiers has built the spare tiers.
+    DLL_EXPORT void Stretch_SetCpuBudget(Stretch* stretch, float microsecondsPerBlock) {
+        stretch->quality->budgetMicroseconds.store(std::max(microsecondsPerBlock, 0.0f), std::memory_order_relaxed);
     }
 
     DLL_EXPORT bool Stretch_Exact(Stretch* stretch, float* input, int pcmLength, float* output, int pcmOutLength) {
+        StretchPipeline_Sync(stretch);
         InterleavedBuffer inBuffer(input, stretch->channels);
         InterleavedBuffer outBuffer(output, stretch->channels);
-        return stretch->stretch->exact(inBuffer, pcmLength, outBuffer, pcmOutLength);
+        bool result = stretch->stretch->exact(inBuffer, pcmLength, outBuffer, pcmOutLength);
+        StretchPipeline_Restart(stretch);
+        return result;
+    }
+
+    // Planar variants: one contiguous buffer per channel, passed straight to the templated
+    // SignalsmithStretch methods without going through InterleavedBuffer/View.
+
+    DLL_EXPORT void Stretch_SeekPlanar(Stretch* stretch, const float* const* input, int inputSamples, double playbackRate) {
+        StretchPipeline_Sync(stretch);
+        stretch->stretch->seek(input, inputSamples, playbackRate);
+        StretchPipeline_Restart(stretch);
+    }
+
+    DLL_EXPORT void Stretch_FlushPlanar(Stretch* stretch, float* const* output, int pcmOutLength, double playbackRate) {
+        StretchPipeline* pipeline = stretch->pipeline;
+        if (!pipeline) {
+            stretch->stretch->flush(output, pcmOutLength, playbackRate);
+            return;
+        }
+
+        // Output still in the pipeline comes before the flushed tail
+        StretchPipeline_Sync(stretch);
+        int queued = StretchPipeline_Drain(stretch, output, pcmOutLength);
+        for (int c = 0; c < stretch->channels; ++c) {
+            pipeline->channelScratch[c] = output[c] + queued;
+        }
+        stretch->stretch->flush(pipeline->channelScratch.data(), pcmOutLength - queued, playbackRate);
+        StretchPipeline_Restart(stretch);
+    }
+
+    DLL_EXPORT void Stretch_OutputSeekPlanar(Stretch* stretch, const float* const* input, int inputLength) {
+        StretchPipeline_Sync(stretch);
+        stretch->stretch->outputSeek(input, inputLength);
+        StretchPipeline_Restart(stretch);
+    }
+
+    DLL_EXPORT void Stretch_ProcessPlanar(Stretch* stretch, const float* const* input, int pcmLength, float* const* output, int pcmOutLength) {
+        processBlock(stretch, input, pcmLength, output, pcmOutLength);
+    }
+
+    DLL_EXPORT bool Stretch_ExactPlanar(Stretch* stretch, const float* const* input, int pcmLength, float* const* output, int pcmOutLength) {
+        StretchPipeline_Sync(stretch);
+        bool result = stretch->stretch->exact(input, pcmLength, output, pcmOutLength);
+        StretchPipeline_Restart(stretch);
+        return result;
+    }
+
+    DLL_EXPORT void Stretch_ProcessBatch(Stretch** instances, const ProcessJob* jobs, int count) {
+        for (int i = 0; i < count; ++i) {
+            processJob(instances[i], jobs[i]);
+        }
+    }
+
+    DLL_EXPORT StretchPool* StretchPool_Create(int threads) {
+        if (threads < 0) {
+            int hardware = (int)std::thread::hardware_concurrency();
+            threads = hardware > 1 ? hardware - 1 : 0;
+        }
+
+        StretchPool* pool = hookNew<StretchPool>(threads + 1);
+        pool->workers.reserve(threads);
+        for (int t = 0; t < threads; ++t) {
+            pool->workers.emplace_back(StretchPool_Worker, pool, t);
+        }
+        return pool;
+    }
+
+    DLL_EXPORT void StretchPool_Release(StretchPool* pool) {
+        StretchPool_WaitIdle(pool);
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            pool->quit = true;
+        }
+        pool->wake.notify_all();
+        for (std::thread& worker : pool->workers) {
+            worker.join();
+        }
+        hookDelete(pool);
+    }
+
+    DLL_EXPORT int StretchPool_Threads(StretchPool* pool) {
+        return (int)pool->workers.size();
+    }
+
+    // Starts processing a batch on the worker threads and returns immediately. Each instance may appear at
+    // most once per batch. If a previous batch is still running, this helps finish it first.
+    // Submit and Wait take no locks, so they can be called from an audio callback; the only allocation is
+    // `tasks` growing the first time a batch is larger than any before it.
+    DLL_EXPORT void StretchPool_Submit(StretchPool* pool, Stretch** instances, const ProcessJob* jobs, int count) {
+        StretchPool_WaitIdle(pool);
+
+        pool->tasks.resize(count);
+        for (int i = 0; i < count; ++i) {
+            pool->tasks[i].stretch = instances[i];
+            pool->tasks[i].job = jobs[i];
+        }
+
+        pool->remaining.store(count, std::memory_order_relaxed);
+        int start = 0;
+        for (int r = 0; r < pool->rangeCount; ++r) {
+            int end = (int)((long long)count * (r + 1) / pool->rangeCount);
+            pool->ranges[r].state.store(StretchPool_RangeState(start, end), std::memory_order_release);
+            start = end;
+        }
+
+        pool->generation.fetch_add(1, std::memory_order_acq_rel);
+        // A worker that misses this wakeup (see wakeWaiters) only costs parallelism, since the caller runs
+        // anything left unclaimed
+        wakeWaiters(pool->mutex, pool->wake);
+    }
+
+    // Helps with the current batch on the calling thread, then spins until the jobs still running on workers finish
+    DLL_EXPORT void StretchPool_Wait(StretchPool* pool) {
+        StretchPool_WaitIdle(pool);
+    }
+
+    // Moves processing onto a background thread: Stretch_Process queues its input and returns output from
+    // earlier blocks, adding maxBlockSamples of output latency (included in Stretch_OutputLatency).
+    // maxBlockSamples is the largest input or output length of any single Process call, and 0 turns it off.
+    // Other calls that touch the stretcher wait for the background thread to go idle first, so while pipelined
+    // they (setters, seek, reset, configure...) must be made from the thread that calls Stretch_Process.
+    // Use Stretch_PostParams to change parameters from another thread.
+    DLL_EXPORT void Stretch_SetPipelined(Stretch* stretch, int maxBlockSamples) {
+        AllocationScope scope(stretch->allocations);
+        StretchPipeline_Stop(stretch);
+        if (maxBlockSamples > 0) {
+            StretchPipeline_Start(stretch, maxBlockSamples);
+        }
+        Binding_Configured();
+    }
+
+    DLL_EXPORT bool Stretch_Pipelined(Stretch* stretch) {
+        return stretch->pipeline != nullptr;
+    }
+
+    // Number of Process calls where the background thread had not produced the output in time
+    DLL_EXPORT int Stretch_PipelineUnderruns(Stretch* stretch) {
+        return stretch->pipeline ? stretch->pipeline->underruns.load() : 0;
+    }
+
+    // Number of output frames Stretch_RenderOffline writes, or 0 if inputFrames is not positive or playbackRate is
+    // not a positive finite number
+    DLL_EXPORT long long Stretch_RenderOfflineLength(long long inputFrames, double playbackRate) {
+        if (inputFrames <= 0 || !(playbackRate > 0) || !std::isfinite(playbackRate)) return 0;
+        double frames = std::ceil(inputFrames / playbackRate);
+        if (frames >= (double)std::numeric_limits<long long>::max()) return 0;
+        return (long long)frames;
+    }
+
+    // Stretches a whole interleaved buffer at a fixed playback rate. Segments are spread across `threads` worker
+    // threads plus the calling thread, as for StretchPool_Create: 0 renders on the caller only, and a negative count
+    // uses one thread per core. `output` must hold Stretch_RenderOfflineLength(inputFrames, playbackRate) frames.
+    // Does nothing if channels or sampleRate is not positive, or the length is 0.
+    DLL_EXPORT void Stretch_RenderOffline(const float* input, long long inputFrames, int channels, float sampleRate, double playbackRate, int threads, float* output, long long seed) {
+        if (channels <= 0 || !(sampleRate > 0) || !std::isfinite(sampleRate)) return;
+
+        OfflineRender render;
+        render.input = input;
+        render.inputFrames = inputFrames;
+        render.channels = channels;
+        render.sampleRate = sampleRate;
+        render.playbackRate = playbackRate;
+        render.seed = seed;
+        render.output = output;
+        render.outputFrames = Stretch_RenderOfflineLength(inputFrames, playbackRate);
+        if (render.outputFrames <= 0) return;
+
+        // Crossfade over one analysis block; segments are 10 seconds of output (or at least 8 crossfades)
+        signalsmith::stretch::SignalsmithStretch<float> probe;
+        probe.presetDefault(channels, sampleRate);
+        render.crossfadeFrames = probe.blockSamples();
+        render.segmentFrames = std::max(render.crossfadeFrames * 8, (int)(sampleRate * 10));
+        long long segmentCount = (render.outputFrames + render.segmentFrames - 1) / render.segmentFrames;
+        if (segmentCount > std::numeric_limits<int>::max()) return;
+        render.segmentCount = (int)segmentCount;
+        render.heads.assign((size_t)render.segmentCount * render.crossfadeFrames * channels, 0.0f);
+        render.nextSegment = 0;
+
+        if (threads < 0) {
+            int hardware = (int)std::thread::hardware_concurrency();
+            threads = hardware > 1 ? hardware - 1 : 0;
+        }
+        threads = std::min(threads, render.segmentCount - 1);
+
+        HookVector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back(RenderOffline_Worker, &render);
+        }
+        RenderOffline_Worker(&render);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        // Raised-cosine crossfade from the end of each segment into the lead-in of the next
+        const double pi = 3.14159265358979323846;
+        for (int segment = 1; segment < render.segmentCount; ++segment) {
+            long long start = (long long)segment * render.segmentFrames - render.crossfadeFrames;
+            const float* head = render.heads.data() + (size_t)segment * render.crossfadeFrames * channels;
+            for (int i = 0; i < render.crossfadeFrames; ++i) {
+                float fadeIn = (float)(0.5 - 0.5 * std::cos(pi * (i + 0.5) / render.crossfadeFrames));
+                float* frame = output + (size_t)(start + i) * channels;
+                for (int c = 0; c < channels; ++c) {
+                    frame[c] += (head[(size_t)i * channels + c] - frame[c]) * fadeIn;
+                }
+            }
+        }
+    }
+
+    // Stretches a whole file at a fixed playback rate through this instance, reading and writing through windowed
+    // memory maps one stretcher block at a time, so neither memory use nor address space grows with the file length.
+    // `inputFormat` is a StretchFileFormat: 0 WAV (PCM 16/24/32-bit or 32-bit float), 1 raw interleaved float32,
+    // 2 raw interleaved int16 (raw input has the instance's channel count and sample rate). WAV input is written as a
+    // 32-bit float WAV at the same sample rate, raw input as raw float32, with Stretch_RenderOfflineLength frames.
+    // The instance is reset before and after. Returns the number of output frames, or -1 if a file can't be opened,
+    // created or mapped, a WAV file has another format, channel count or sample rate than the instance, or the
+    // output would be too large to address.
+    DLL_EXPORT long long Stretch_RenderFile(Stretch* stretch, const char* inputPath, int inputFormat, const char* outputPath, double playbackRate) {
+        AllocationScope scope(stretch->allocations);
+        int channels = stretch->channels;
+        if (!(playbackRate > 0) || channels <= 0) return -1;
+        MappedFile input;
+        if (!Binding_MapRead(inputPath, input)) return -1;
+
+        WavInfo info;
+        bool wav = inputFormat == fileFormatWav;
+        bool valid;
+        if (wav) {
+            valid = Binding_ParseWav(input, info) && info.channels == channels && info.sampleRate == stretch->sampleRate;
+        } else {
+            valid = inputFormat == fileFormatRawFloat32 || inputFormat == fileFormatRawInt16;
+            info.format = inputFormat == fileFormatRawInt16 ? sampleInt16 : sampleFloat32;
+            info.channels = channels;
+            info.sampleRate = stretch->sampleRate;
+            info.dataOffset = 0;
+            info.frames = input.size / (Binding_SampleBytes(info.format) * channels);
+        }
+
+        int block = stretch->stretch->blockSamples();
+        if (block <= 0) block = 4096;
+        size_t inputFrameBytes = Binding_SampleBytes(info.format) * channels;
+        size_t outputFrameBytes = sizeof(float) * channels;
+        unsigned long long headerBytes = wav ? wavHeaderBytes : 0;
+        // The output length must fit a 64-bit file offset, and one block of input (which grows with the playback rate)
+        // must fit an int sample count and a single mapped window, even with a 32-bit address space
+        double outputLength = valid ? std::ceil((double)info.frames / playbackRate) : 0;
+        double maxBlockInput = std::ceil(block * playbackRate) + 1;
+        if (!(outputLength < (double)((std::numeric_limits<long long>::max() - headerBytes) / outputFrameBytes)) || !(maxBlockInput * inputFrameBytes < (double)std::numeric_limits<int>::max())) {
+            valid = false;
+        }
+
+        long long outputFrames = valid ? (long long)outputLength : 0;
+        MappedFile output;
+        if (!valid || !Binding_MapCreate(outputPath, headerBytes + (unsigned long long)outputFrames * outputFrameBytes, output)) {
+            Binding_Unmap(input);
+            return -1;
+        }
+        bool failed = false;
+        if (wav) {
+            unsigned char* header = Binding_MapRange(output, 0, wavHeaderBytes, renderFileWindowBytes);
+            if (header) {
+                Binding_WriteWavHeader(header, channels, info.sampleRate, (unsigned long long)outputFrames);
+            } else {
+                failed = true;
+            }
+        }
+
+        int pipelineBlock = StretchPipeline_Stop(stretch);
+        StretchQuality_Reset(stretch);
+
+        // Pre-roll so output frame n lines up with input frame n * playbackRate, as in Stretch_RenderOffline
+        int seekLength = stretch->stretch->outputSeekLength((float)playbackRate);
+        StretchScratch_Prepare(stretch, seekLength, 0);
+        if (!failed && RenderFile_Load(stretch, input, info, 0, seekLength)) {
+            const float* const* seekInputs = stretch->scratch->inputChannels.data();
+            stretch->stretch->outputSeek(seekInputs, seekLength);
+        } else {
+            failed = true;
+        }
+
+        // One call in the stats, like the streaming calls. The CPU budget is left out, since this isn't real-time.
+        StretchStatsTimer timer(stretch->stats, 0, outputFrames);
+        long long inputDone = 0;
+        for (long long outputDone = 0; !failed && outputDone < outputFrames;) {
+            int length = (int)std::min((long long)block, outputFrames - outputDone);
+            long long inputEnd = (long long)std::floor((outputDone + length) * playbackRate + 0.5);
+            int inputLength = (int)(inputEnd - inputDone);
+
+            StretchScratch_Prepare(stretch, inputLength, length);
+            if (!RenderFile_Load(stretch, input, info, seekLength + inputDone, inputLength)) {
+                failed = true;
+                break;
+            }
+            const float* const* inputs = stretch->scratch->inputChannels.data();
+            float* const* outputs = stretch->scratch->outputChannels.data();
+            processUntimed(stretch, inputs, inputLength, outputs, length, false);
+            unsigned char* outputBytes = Binding_MapRange(output, headerBytes + (unsigned long long)outputDone * outputFrameBytes, (size_t)length * outputFrameBytes, renderFileWindowBytes);
+            if (!outputBytes) {
+                failed = true;
+                break;
+            }
+            Binding_Interleave(outputs, channels, length, reinterpret_cast<float*>(outputBytes));
+            inputDone = inputEnd;
+            outputDone += length;
+        }
+        timer.setInputSamples(inputDone);
+
+        Binding_Unmap(input);
+        Binding_Unmap(output);
+        StretchQuality_Reset(stretch);
+        if (pipelineBlock > 0) StretchPipeline_Start(stretch, pipelineBlock);
+        return failed ? -1 : outputFrames;
+    }
+
+    // Creates `count` instances up front, each set up with the given preset (0 default, 1 cheaper, 2 low latency).
+    // Instances are seeded with seed, seed + 1, ... so renders are repeatable.
+    DLL_EXPORT StretchInstancePool* StretchInstancePool_Create(int count, int nChannels, float sampleRate, int preset, bool splitComputation, long long seed) {
+        count = std::max(count, 0);
+        StretchInstancePool* pool = hookNew<StretchInstancePool>(count);
+        for (int i = 0; i < count; ++i) {
+            Stretch* stretch = Stretch_CreateSeed((long)(seed + i));
+            if (preset == stretchPresetCheaper) {
+                Stretch_PresetCheaper(stretch, nChannels, sampleRate, splitComputation);
+            } else if (preset == stretchPresetLowLatency) {
+                Stretch_PresetLowLatency(stretch, nChannels, sampleRate, splitComputation);
+            } else {
+                Stretch_PresetDefault(stretch, nChannels, sampleRate, splitComputation);
+            }
+            pool->instances[i] = stretch;
+        }
+        for (int i = count - 1; i >= 0; --i) {
+            StretchInstancePool_Push(pool, i);
+        }
+        return pool;
+    }
+
+    // Releases every instance, so all rented ones must have been returned (or abandoned) first
+    DLL_EXPORT void StretchInstancePool_Release(StretchInstancePool* pool) {
+        for (Stretch* stretch : pool->instances) {
+            Stretch_Release(stretch);
+        }
+        hookDelete(pool);
+    }
+
+    DLL_EXPORT int StretchInstancePool_Capacity(StretchInstancePool* pool) {
+        return (int)pool->instances.size();
+    }
+
+    DLL_EXPORT int StretchInstancePool_Available(StretchInstancePool* pool) {
+        return pool->available.load(std::memory_order_relaxed);
+    }
+
+    // Hands out a ready-to-use instance, or null if they are all rented. Lock-free and allocation-free.
+    DLL_EXPORT Stretch* StretchInstancePool_Rent(StretchInstancePool* pool) {
+        int index = StretchInstancePool_Pop(pool);
+        if (index < 0) return nullptr;
+        pool->rented[index].store(true, std::memory_order_relaxed);
+        return pool->instances[index];
+    }
+
+    // Resets the instance and makes it available again. Lock-free and allocation-free, apart from releasing a
+    // frequency map set on the instance. Pipelined instances are waited on first (see Stretch_SetPipelined).
+    // Returns false, doing nothing, for an instance from elsewhere or one that isn't currently rented.
+    DLL_EXPORT bool StretchInstancePool_Return(StretchInstancePool* pool, Stretch* stretch) {
+        for (size_t i = 0; i < pool->instances.size(); ++i) {
+            if (pool->instances[i] == stretch) {
+                if (!pool->rented[i].exchange(false, std::memory_order_relaxed)) return false;
+                StretchInstancePool_Recycle(stretch);
+                StretchInstancePool_Push(pool, (int)i);
+                return true;
+            }
+        }
+        return false;
     }
-}
\ No newline at end of file
+}
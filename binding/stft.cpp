@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include "signalsmith-linear/stft.h"
+#include "./allocator.h"
+#include "./convert.h"
 
 #if defined(_WIN32) || defined(__CYGWIN__)
     #define DLL_EXPORT __declspec(dllexport)
@@ -9,481 +13,598 @@
     #define DLL_EXPORT
 #endif
 
-// Abstract base class for STFT to allow for different template instantiations
-
 enum STFTWindowShape { ignore, acg, kaiser };
 
+// Common header of every STFT handle, recording which template instantiation it is
 class BaseSTFT {
 public:
+    bool splitComputation;
+    int inChannels;
+    int outChannels;
+    int extraInputHistory;
     float complex[2];
-
-    virtual ~BaseSTFT() = default;
-
-    virtual void configure(int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry) = 0;
-    virtual size_t blockSamples() const = 0;
-    virtual size_t fftSamples() const = 0;
-    virtual size_t defaultInterval() const = 0;
-    virtual size_t bands() const = 0;
-    virtual size_t analysisLatency() const = 0;
-    virtual size_t synthesisLatency() const = 0;
-    virtual size_t latency() const = 0;
-    virtual void reset() = 0;
-
-    virtual float binToFreq(float b) const = 0;
-    virtual float freqToBin(float f) const = 0;
-
-    virtual void writeInput(size_t channel, size_t offset, size_t length, const float* inputArray) = 0;
-    virtual void moveInput(size_t samples, bool clearMovedRegion) = 0;
-
-    virtual size_t samplesSinceAnalysis() const = 0;
-    virtual void finishOutput(float strength = 0.0f, size_t offset = 0) = 0;
-    virtual void readOutput(size_t channel, size_t offset, size_t length, float* outputArray) = 0;
-    virtual void addOutput(size_t channel, size_t offset, size_t length, const float* outputArray) = 0;
-    virtual void replaceOutput(size_t channel, size_t offset, size_t length, const float* outputArray) = 0;
-    virtual void moveOutput(size_t samples) = 0;
-    virtual size_t samplesSinceSynthesis() const = 0;
-    virtual std::complex<float>* spectrum(size_t channel) = 0;
-    virtual float* analysisWindow() = 0;
-    virtual void analysisOffset(size_t offset) = 0;
-    virtual float* synthesisWindow() = 0;
-    virtual void synthesisOffset(size_t offset) = 0;
-
-    virtual void setInterval(size_t defaultInterval, STFTWindowShape windowShape, float asymmetry) = 0;
-    virtual void analyse(size_t sampleInPast = 0) = 0;
-    virtual size_t analyseSteps() const = 0;
-    virtual void analyseStep(size_t step, size_t sampleInPast = 0) = 0;
-    virtual void synthesise() = 0;
-    virtual size_t synthesiseSteps() const = 0;
-    virtual void synthesiseStep(size_t step) = 0;
+    AllocationCounter allocations; // see STFT_AllocationsSinceConfigure
 };
 
-class STFT : public BaseSTFT {
-    signalsmith::linear::DynamicSTFT<float, false> stft;
-
-    std::vector<std::complex<float>> inputBuffer;
-    std::vector<std::complex<float>> outputBuffer;
-
-public:
-    ~STFT() override = default;
-
-    void configure(int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry) override {
-        stft.configure(inChannels, outChannels, blockSamples, extraInputHistory, intervalSamples, asymmetry);
-    }
-
-    size_t blockSamples() const override {
-        return stft.blockSamples();
-    }
-
-    size_t fftSamples() const override {
-        return stft.fftSamples();
-    }
-
-    size_t defaultInterval() const override {
-        return stft.defaultInterval();
-    }
+// Called by STFT_ProcessBlock once per frame, between analysis and synthesis. `spectra` holds one pointer per
+// channel (the larger of the input and output counts), each `bands` interleaved (real, imaginary) pairs to edit in place.
+typedef void (*STFTSpectralCallback)(void* userData, float** spectra, int channels, int bands);
+
+// Per-call CPU report for an STFTScheduler (STFTScheduler_Report)
+struct STFTScheduleReport {
+    int stepsPerHop;      // analyse steps + 1 (spectral callback) + synthesise steps
+    int expectedSteps;    // stepsPerHop spread over one callback of the configured size
+    int stepsRun;         // steps run by the last STFTScheduler_Process call
+    int maxStepsRun;      // most steps run by any call since configure
+    int hopsCompleted;    // hops finished by the last call
+    float microseconds;   // time spent in the last call
+    float maxMicroseconds;
+};
 
-    size_t bands() const override {
-        return stft.bands();
-    }
+// Spreads each hop's analyse steps, spectral callback and synthesise steps evenly across the following hop interval,
+// so every audio callback does a similar share of the work instead of all of it landing on hop boundaries.
+// Each hop finishes synthesising on the next boundary, adding one interval of latency compared to STFT_ProcessBlock.
+struct STFTScheduler {
+    BaseSTFT* stft;
+    size_t interval;
+    size_t callbackSamples;
+    size_t position;    // samples since the current hop started
+    size_t stepsDone;   // steps of the current hop already run
+    STFTScheduleReport report;
+};
 
-    size_t analysisLatency() const override {
-        return stft.analysisLatency();
-    }
+// One implementation for both DynamicSTFT variants. Every operation is a static function taking the handle,
+// so the exports below can call a specific instantiation directly with no virtual dispatch.
+template<bool split>
+class STFTImpl : public BaseSTFT {
+    typedef signalsmith::linear::DynamicSTFT<float, split> Inner;
 
-    size_t synthesisLatency() const override {
-        return stft.synthesisLatency();
-    }
+    Inner stft;
 
-    size_t latency() const override {
-        return stft.latency();
-    }
+    // Planar staging for the interleaved transfers, one block per channel, sized on configure. Longer calls are
+    // split into block-sized chunks so nothing is allocated while processing.
+    HookVector<float> scratch;
+    HookVector<float*> scratchChannels;
+    size_t scratchLength;
+    // Per-channel spectrum pointers handed to the STFT_ProcessBlock callback
+    HookVector<float*> spectra;
 
-    void reset() override {
-        stft.reset();
+    static Inner& inner(BaseSTFT* stftBase) {
+        return static_cast<STFTImpl*>(stftBase)->stft;
     }
 
-    float binToFreq(float b) const override {
-        return stft.binToFreq(b);
+    static float* const* scratchChannelsOf(BaseSTFT* stftBase) {
+        return static_cast<STFTImpl*>(stftBase)->scratchChannels.data();
     }
 
-    float freqToBin(float f) const override {
-        return stft.freqToBin(f);
+    static size_t scratchLengthOf(BaseSTFT* stftBase) {
+        return static_cast<STFTImpl*>(stftBase)->scratchLength;
     }
 
-    void writeInput(size_t channel, size_t offset, size_t length, const float* inputArray) override {
-        stft.writeInput(channel, offset, length, inputArray);
+public:
+    STFTImpl() {
+        splitComputation = split;
+        inChannels = 0;
+        outChannels = 0;
+        extraInputHistory = 0;
+        allocations = 0;
+        scratchLength = 0;
+    }
+
+    static BaseSTFT* Create() {
+        return hookNew<STFTImpl>();
+    }
+
+    static void Delete(BaseSTFT* stftBase) {
+        inner(stftBase).reset();
+        hookDelete(static_cast<STFTImpl*>(stftBase));
+    }
+
+    static void Configure(BaseSTFT* stftBase, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry) {
+        AllocationScope scope(stftBase->allocations);
+        inner(stftBase).configure(inChannels, outChannels, blockSamples, extraInputHistory, intervalSamples, asymmetry);
+        stftBase->inChannels = inChannels;
+        stftBase->outChannels = outChannels;
+        stftBase->extraInputHistory = extraInputHistory;
+        STFTImpl* impl = static_cast<STFTImpl*>(stftBase);
+        size_t channels = std::max(std::max(inChannels, outChannels), 0);
+        impl->scratchLength = std::max(blockSamples, 0);
+        impl->scratch.assign(channels * impl->scratchLength, 0);
+        impl->scratchChannels.resize(channels);
+        for (size_t c = 0; c < channels; ++c) {
+            impl->scratchChannels[c] = impl->scratch.data() + c * impl->scratchLength;
+        }
+        impl->spectra.resize(channels);
+        Binding_Configured();
     }
 
-    void readOutput(size_t channel, size_t offset, size_t length, float* outputArray) override {
-        stft.readOutput(channel, offset, length, outputArray);
+    static size_t BlockSamples(BaseSTFT* stftBase) {
+        return inner(stftBase).blockSamples();
     }
 
-    void moveInput(size_t samples, bool clearMovedRegion) override {
-        stft.moveInput(samples, clearMovedRegion);
+    static size_t FFTSamples(BaseSTFT* stftBase) {
+        return inner(stftBase).fftSamples();
     }
 
-    size_t samplesSinceAnalysis() const override {
-        return stft.samplesSinceAnalysis();
+    static size_t DefaultInterval(BaseSTFT* stftBase) {
+        return inner(stftBase).defaultInterval();
     }
 
-    void finishOutput(float strength = 0.0f, size_t offset = 0) override {
-        stft.finishOutput(strength, offset);
+    static size_t Bands(BaseSTFT* stftBase) {
+        return inner(stftBase).bands();
     }
 
-    void addOutput(size_t channel, size_t offset, size_t length, const float* outputArray) override {
-        stft.addOutput(channel, offset, length, outputArray);
+    static void Reset(BaseSTFT* stftBase) {
+        inner(stftBase).reset();
     }
 
-    void replaceOutput(size_t channel, size_t offset, size_t length, const float* outputArray) override {
-        stft.replaceOutput(channel, offset, length, outputArray);
+    static size_t MemoryFootprint(BaseSTFT* stftBase) {
+        STFTImpl* impl = static_cast<STFTImpl*>(stftBase);
+        return sizeof(STFTImpl) + impl->scratch.capacity() * sizeof(float) + (impl->scratchChannels.capacity() + impl->spectra.capacity()) * sizeof(float*);
     }
 
-    void moveOutput(size_t samples) override {
-        stft.moveOutput(samples);
+    static void WriteInput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* inputArray) {
+        inner(stftBase).writeInput(channel, offset, length, inputArray);
     }
 
-    size_t samplesSinceSynthesis() const override {
-        return stft.samplesSinceSynthesis();
+    static void ReadOutput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, float* outputArray) {
+        inner(stftBase).readOutput(channel, offset, length, outputArray);
     }
 
-    std::complex<float>* spectrum(size_t channel) override {
-        return stft.spectrum(channel);
+    static void WriteInputInterleaved(BaseSTFT* stftBase, size_t offset, size_t length, const float* interleavedInput) {
+        float* const* buffers = scratchChannelsOf(stftBase);
+        size_t channels = stftBase->inChannels, maxChunk = scratchLengthOf(stftBase);
+        for (size_t done = 0; done < length && maxChunk > 0;) {
+            size_t chunk = std::min(maxChunk, length - done);
+            Binding_Deinterleave(interleavedInput + done * channels, sampleFloat32, channels, chunk, buffers);
+            for (size_t c = 0; c < channels; ++c) {
+                inner(stftBase).writeInput(c, offset + done, chunk, buffers[c]);
+            }
+            done += chunk;
+        }
     }
 
-    float* analysisWindow() override {
-        return stft.analysisWindow();
+    static void WriteInputPlanar(BaseSTFT* stftBase, size_t offset, size_t length, const float* const* inputs) {
+        for (int c = 0; c < stftBase->inChannels; ++c) {
+            inner(stftBase).writeInput(c, offset, length, inputs[c]);
+        }
     }
 
-    void analysisOffset(size_t offset) override {
-        stft.analysisOffset(offset);
+    static void ReadOutputInterleaved(BaseSTFT* stftBase, size_t offset, size_t length, float* interleavedOutput) {
+        float* const* buffers = scratchChannelsOf(stftBase);
+        size_t channels = stftBase->outChannels, maxChunk = scratchLengthOf(stftBase);
+        for (size_t done = 0; done < length && maxChunk > 0;) {
+            size_t chunk = std::min(maxChunk, length - done);
+            for (size_t c = 0; c < channels; ++c) {
+                inner(stftBase).readOutput(c, offset + done, chunk, buffers[c]);
+            }
+            Binding_Interleave(buffers, channels, chunk, interleavedOutput + done * channels);
+            done += chunk;
+        }
     }
 
-    float* synthesisWindow() override {
-        return stft.synthesisWindow();
+    static void ReadOutputPlanar(BaseSTFT* stftBase, size_t offset, size_t length, float* const* outputs) {
+        for (int c = 0; c < stftBase->outChannels; ++c) {
+            inner(stftBase).readOutput(c, offset, length, outputs[c]);
+        }
     }
 
-    void synthesisOffset(size_t offset) override {
-        stft.synthesisOffset(offset);
+    static void MoveInput(BaseSTFT* stftBase, size_t samples, bool clearMovedRegion) {
+        inner(stftBase).moveInput(samples, clearMovedRegion);
     }
 
-    void setInterval(size_t defaultInterval, STFTWindowShape windowShape, float asymmetry) override {
-        signalsmith::linear::DynamicSTFT<float, false>::WindowShape shape = signalsmith::linear::DynamicSTFT<float, false>::WindowShape::ignore;
+    static void SetInterval(BaseSTFT* stftBase, size_t defaultInterval, STFTWindowShape windowShape, float asymmetry) {
+        typename Inner::WindowShape shape = Inner::WindowShape::ignore;
         if (windowShape == acg) {
-            shape = signalsmith::linear::DynamicSTFT<float, false>::acg;
+            shape = Inner::acg;
         } else if (windowShape == kaiser) {
-            shape = signalsmith::linear::DynamicSTFT<float, false>::kaiser;
+            shape = Inner::kaiser;
         }
-        stft.setInterval(defaultInterval, shape, asymmetry);
+        inner(stftBase).setInterval(defaultInterval, shape, asymmetry);
     }
 
-    void analyse(size_t sampleInPast = 0) override {
-        stft.analyse(sampleInPast);
+    static void Analyse(BaseSTFT* stftBase, size_t sampleInPast) {
+        inner(stftBase).analyse(sampleInPast);
     }
 
-    size_t analyseSteps() const override {
-        return stft.analyseSteps();
+    static void Synthesise(BaseSTFT* stftBase) {
+        inner(stftBase).synthesise();
     }
 
-    void analyseStep(size_t step, size_t sampleInPast = 0) override {
-        stft.analyseStep(step, sampleInPast);
-    }
-
-    void synthesise() override {
-        stft.synthesise();
-    }
+    static float* Spectrum(BaseSTFT* stftBase, size_t channel) {
+        std::complex<float>* spec = inner(stftBase).spectrum(channel);
+        stftBase->complex[0] = spec->real();
+        stftBase->complex[1] = spec->imag();
 
-    size_t synthesiseSteps() const override {
-        return stft.synthesiseSteps();
+        return stftBase->complex;
     }
 
-    void synthesiseStep(size_t step) override {
-        stft.synthesiseStep(step);
+    static float* SpectrumPtr(BaseSTFT* stftBase, size_t channel) {
+        return reinterpret_cast<float*>(inner(stftBase).spectrum(channel));
     }
-};
-
-class SFTF_SplitComputation : public BaseSTFT {
-    signalsmith::linear::DynamicSTFT<float, true> stft;
-
-    std::vector<std::complex<float>> inputBuffer;
-    std::vector<std::complex<float>> outputBuffer;
-
-public:
-    ~SFTF_SplitComputation() override = default;
 
-    void configure(int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry) override {
-        stft.configure(inChannels, outChannels, blockSamples, extraInputHistory, intervalSamples, asymmetry);
+    static void ReadSpectrum(BaseSTFT* stftBase, size_t channel, float* outputReal, float* outputImag) {
+        const std::complex<float>* spec = inner(stftBase).spectrum(channel);
+        size_t bands = inner(stftBase).bands();
+        for (size_t b = 0; b < bands; ++b) {
+            outputReal[b] = spec[b].real();
+            outputImag[b] = spec[b].imag();
+        }
     }
 
-    size_t blockSamples() const override {
-        return stft.blockSamples();
+    static void ReadSpectrumInterleaved(BaseSTFT* stftBase, size_t channel, float* interleavedOutput) {
+        std::memcpy(interleavedOutput, (const void*)inner(stftBase).spectrum(channel), inner(stftBase).bands() * sizeof(std::complex<float>));
     }
 
-    size_t fftSamples() const override {
-        return stft.fftSamples();
+    static void WriteSpectrum(BaseSTFT* stftBase, size_t channel, const float* inputReal, const float* inputImag) {
+        std::complex<float>* spec = inner(stftBase).spectrum(channel);
+        size_t bands = inner(stftBase).bands();
+        for (size_t b = 0; b < bands; ++b) {
+            spec[b] = std::complex<float>(inputReal[b], inputImag[b]);
+        }
     }
 
-    size_t defaultInterval() const override {
-        return stft.defaultInterval();
+    static void WriteSpectrumInterleaved(BaseSTFT* stftBase, size_t channel, const float* interleavedInput) {
+        std::memcpy((void*)inner(stftBase).spectrum(channel), interleavedInput, inner(stftBase).bands() * sizeof(std::complex<float>));
     }
 
-    size_t bands() const override {
-        return stft.bands();
+    static float* AnalysisWindow(BaseSTFT* stftBase) {
+        return inner(stftBase).analysisWindow();
     }
 
-    size_t analysisLatency() const override {
-        return stft.analysisLatency();
+    static float* SynthesisWindow(BaseSTFT* stftBase) {
+        return inner(stftBase).synthesisWindow();
     }
 
-    size_t synthesisLatency() const override {
-        return stft.synthesisLatency();
+    static size_t AnalysisLatency(BaseSTFT* stftBase) {
+        return inner(stftBase).analysisLatency();
     }
 
-    size_t latency() const override {
-        return stft.latency();
+    static size_t SynthesisLatency(BaseSTFT* stftBase) {
+        return inner(stftBase).synthesisLatency();
     }
 
-    void reset() override {
-        stft.reset();
+    static size_t Latency(BaseSTFT* stftBase) {
+        return inner(stftBase).latency();
     }
 
-    float binToFreq(float b) const override {
-        return stft.binToFreq(b);
+    static float BinToFreq(BaseSTFT* stftBase, float b) {
+        return inner(stftBase).binToFreq(b);
     }
 
-    float freqToBin(float f) const override {
-        return stft.freqToBin(f);
+    static float FreqToBin(BaseSTFT* stftBase, float f) {
+        return inner(stftBase).freqToBin(f);
     }
 
-    void writeInput(size_t channel, size_t offset, size_t length, const float* inputArray) override {
-        stft.writeInput(channel, offset, length, inputArray);
+    static size_t AnalyseSteps(BaseSTFT* stftBase) {
+        return inner(stftBase).analyseSteps();
     }
 
-    void readOutput(size_t channel, size_t offset, size_t length, float* outputArray) override {
-        stft.readOutput(channel, offset, length, outputArray);
+    static size_t SynthesiseSteps(BaseSTFT* stftBase) {
+        return inner(stftBase).synthesiseSteps();
     }
 
-    void moveInput(size_t samples, bool clearMovedRegion) override {
-        stft.moveInput(samples, clearMovedRegion);
+    static void AnalyseStep(BaseSTFT* stftBase, size_t step, size_t sampleInPast) {
+        inner(stftBase).analyseStep(step, sampleInPast);
     }
 
-    size_t samplesSinceAnalysis() const override {
-        return stft.samplesSinceAnalysis();
+    static void SynthesiseStep(BaseSTFT* stftBase, size_t step) {
+        inner(stftBase).synthesiseStep(step);
     }
 
-    void finishOutput(float strength = 0.0f, size_t offset = 0) override {
-        stft.finishOutput(strength, offset);
+    static size_t SamplesSinceAnalysis(BaseSTFT* stftBase) {
+        return inner(stftBase).samplesSinceAnalysis();
     }
 
-    void addOutput(size_t channel, size_t offset, size_t length, const float* outputArray) override {
-        stft.addOutput(channel, offset, length, outputArray);
+    static size_t SamplesSinceSynthesis(BaseSTFT* stftBase) {
+        return inner(stftBase).samplesSinceSynthesis();
     }
 
-    void replaceOutput(size_t channel, size_t offset, size_t length, const float* outputArray) override {
-        stft.replaceOutput(channel, offset, length, outputArray);
+    static void FinishOutput(BaseSTFT* stftBase, float strength, size_t offset) {
+        inner(stftBase).finishOutput(strength, offset);
     }
 
-    void moveOutput(size_t samples) override {
-        stft.moveOutput(samples);
+    static void AddOutput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* outputArray) {
+        inner(stftBase).addOutput(channel, offset, length, outputArray);
     }
 
-    size_t samplesSinceSynthesis() const override {
-        return stft.samplesSinceSynthesis();
+    static void ReplaceOutput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* outputArray) {
+        inner(stftBase).replaceOutput(channel, offset, length, outputArray);
     }
 
-    std::complex<float>* spectrum(size_t channel) override {
-        return stft.spectrum(channel);
+    static void AddOutputInterleaved(BaseSTFT* stftBase, size_t offset, size_t length, const float* interleavedOutput) {
+        float* const* buffers = scratchChannelsOf(stftBase);
+        size_t channels = stftBase->outChannels, maxChunk = scratchLengthOf(stftBase);
+        for (size_t done = 0; done < length && maxChunk > 0;) {
+            size_t chunk = std::min(maxChunk, length - done);
+            Binding_Deinterleave(interleavedOutput + done * channels, sampleFloat32, channels, chunk, buffers);
+            for (size_t c = 0; c < channels; ++c) {
+                inner(stftBase).addOutput(c, offset + done, chunk, buffers[c]);
+            }
+            done += chunk;
+        }
     }
 
-    float* analysisWindow() override {
-        return stft.analysisWindow();
+    static void AddOutputPlanar(BaseSTFT* stftBase, size_t offset, size_t length, const float* const* outputs) {
+        for (int c = 0; c < stftBase->outChannels; ++c) {
+            inner(stftBase).addOutput(c, offset, length, outputs[c]);
+        }
     }
 
-    void analysisOffset(size_t offset) override {
-        stft.analysisOffset(offset);
+    static void ReplaceOutputInterleaved(BaseSTFT* stftBase, size_t offset, size_t length, const float* interleavedOutput) {
+        float* const* buffers = scratchChannelsOf(stftBase);
+        size_t channels = stftBase->outChannels, maxChunk = scratchLengthOf(stftBase);
+        for (size_t done = 0; done < length && maxChunk > 0;) {
+            size_t chunk = std::min(maxChunk, length - done);
+            Binding_Deinterleave(interleavedOutput + done * channels, sampleFloat32, channels, chunk, buffers);
+            for (size_t c = 0; c < channels; ++c) {
+                inner(stftBase).replaceOutput(c, offset + done, chunk, buffers[c]);
+            }
+            done += chunk;
+        }
     }
 
-    float* synthesisWindow() override {
-        return stft.synthesisWindow();
+    static void ReplaceOutputPlanar(BaseSTFT* stftBase, size_t offset, size_t length, const float* const* outputs) {
+        for (int c = 0; c < stftBase->outChannels; ++c) {
+            inner(stftBase).replaceOutput(c, offset, length, outputs[c]);
+        }
     }
 
-    void synthesisOffset(size_t offset) override {
-        stft.synthesisOffset(offset);
+    static void MoveOutput(BaseSTFT* stftBase, size_t samples) {
+        inner(stftBase).moveOutput(samples);
     }
 
-    void setInterval(size_t defaultInterval, STFTWindowShape windowShape, float asymmetry) override {
-        signalsmith::linear::DynamicSTFT<float, true>::WindowShape shape = signalsmith::linear::DynamicSTFT<float, true>::WindowShape::ignore;
-        if (windowShape == acg) {
-            shape = signalsmith::linear::DynamicSTFT<float, true>::acg;
-        } else if (windowShape == kaiser) {
-            shape = signalsmith::linear::DynamicSTFT<float, true>::kaiser;
+    // Runs the whole hop schedule for a block of interleaved audio: input is written and output read in chunks
+    // that end on hop boundaries, and each hop analyses, calls `callback` (if any) and synthesises.
+    // Processes min(inputLength, outputLength) samples, and zeroes any output beyond that.
+    static void ProcessBlock(BaseSTFT* stftBase, const float* input, size_t inputLength, float* output, size_t outputLength, STFTSpectralCallback callback, void* userData) {
+        STFTImpl* impl = static_cast<STFTImpl*>(stftBase);
+        Inner& stft = impl->stft;
+        size_t interval = stft.defaultInterval();
+        size_t length = std::min(inputLength, outputLength);
+        std::fill(output + length * stftBase->outChannels, output + outputLength * stftBase->outChannels, 0.0f);
+        if (interval == 0) {
+            std::fill(output, output + length * stftBase->outChannels, 0.0f);
+            return;
         }
-        stft.setInterval(defaultInterval, shape, asymmetry);
-    }
 
-    void analyse(size_t sampleInPast = 0) override {
-        stft.analyse(sampleInPast);
+        size_t done = 0;
+        while (done < length) {
+            size_t sinceAnalysis = std::min(stft.samplesSinceAnalysis(), interval);
+            size_t chunk = std::min(length - done, interval - sinceAnalysis);
+            if (chunk > 0) {
+                WriteInputInterleaved(stftBase, 0, chunk, input + done * stftBase->inChannels);
+                stft.moveInput(chunk);
+                ReadOutputInterleaved(stftBase, 0, chunk, output + done * stftBase->outChannels);
+                stft.moveOutput(chunk);
+                done += chunk;
+            }
+
+            if (stft.samplesSinceAnalysis() >= interval) {
+                stft.analyse();
+                if (callback) {
+                    for (size_t c = 0; c < impl->spectra.size(); ++c) {
+                        impl->spectra[c] = reinterpret_cast<float*>(stft.spectrum(c));
+                    }
+                    callback(userData, impl->spectra.data(), (int)impl->spectra.size(), (int)stft.bands());
+                }
+                stft.synthesise();
+            }
+        }
     }
 
-    size_t analyseSteps() const override {
-        return stft.analyseSteps();
+    static int StepsPerHop(BaseSTFT* stftBase) {
+        return (int)(inner(stftBase).analyseSteps() + 1 + inner(stftBase).synthesiseSteps());
     }
 
-    void analyseStep(size_t step, size_t sampleInPast = 0) override {
-        stft.analyseStep(step, sampleInPast);
-    }
+    // Like ProcessBlock, but runs only the share of the hop's steps that is due at each point in the interval
+    static void Schedule(STFTScheduler* scheduler, const float* input, float* output, size_t length, STFTSpectralCallback callback, void* userData) {
+        BaseSTFT* stftBase = scheduler->stft;
+        STFTImpl* impl = static_cast<STFTImpl*>(stftBase);
+        Inner& stft = impl->stft;
+        size_t analyseSteps = stft.analyseSteps();
+        size_t totalSteps = (size_t)StepsPerHop(stftBase);
+        size_t interval = scheduler->interval;
+        // also catches the STFT being reconfigured with less history since STFTScheduler_Configure
+        if (interval == 0 || interval > (size_t)stftBase->extraInputHistory) {
+            std::fill(output, output + length * stftBase->outChannels, 0.0f);
+            return;
+        }
 
-    void synthesise() override {
-        stft.synthesise();
+        STFTScheduleReport& report = scheduler->report;
+        report.stepsRun = 0;
+        report.hopsCompleted = 0;
+
+        size_t done = 0;
+        while (done < length) {
+            size_t chunk = std::min(length - done, interval - scheduler->position);
+            WriteInputInterleaved(stftBase, 0, chunk, input + done * stftBase->inChannels);
+            stft.moveInput(chunk);
+            ReadOutputInterleaved(stftBase, 0, chunk, output + done * stftBase->outChannels);
+            stft.moveOutput(chunk);
+            scheduler->position += chunk;
+            done += chunk;
+
+            size_t due = totalSteps * scheduler->position / interval;
+            for (; scheduler->stepsDone < due; ++scheduler->stepsDone) {
+                size_t step = scheduler->stepsDone;
+                if (step < analyseSteps) {
+                    // The hop started `position` samples ago, so analyse relative to that
+                    stft.analyseStep(step, scheduler->position);
+                } else if (step == analyseSteps) {
+                    if (callback) {
+                        for (size_t c = 0; c < impl->spectra.size(); ++c) {
+                            impl->spectra[c] = reinterpret_cast<float*>(stft.spectrum(c));
+                        }
+                        callback(userData, impl->spectra.data(), (int)impl->spectra.size(), (int)stft.bands());
+                    }
+                } else {
+                    stft.synthesiseStep(step - analyseSteps - 1);
+                }
+                ++report.stepsRun;
+            }
+
+            if (scheduler->position == interval) {
+                scheduler->position = 0;
+                scheduler->stepsDone = 0;
+                ++report.hopsCompleted;
+            }
+        }
     }
 
-    size_t synthesiseSteps() const override {
-        return stft.synthesiseSteps();
+    static void AnalysisOffset(BaseSTFT* stftBase, size_t offset) {
+        inner(stftBase).analysisOffset(offset);
     }
 
-    void synthesiseStep(size_t step) override {
-        stft.synthesiseStep(step);
+    static void SynthesisOffset(BaseSTFT* stftBase, size_t offset) {
+        inner(stftBase).synthesisOffset(offset);
     }
 };
 
+// Exports one operation three ways: STFT_Plain_<name> and STFT_Split_<name> only accept handles of that variant,
+// while STFT_<name> accepts either and branches on the handle's flag
+#define STFT_EXPORT(ret, name, params, args) \
+    DLL_EXPORT ret STFT_Plain_##name params { return STFTImpl<false>::name args; } \
+    DLL_EXPORT ret STFT_Split_##name params { return STFTImpl<true>::name args; } \
+    DLL_EXPORT ret STFT_##name params { return stftBase->splitComputation ? STFTImpl<true>::name args : STFTImpl<false>::name args; }
+
 extern "C" {
     DLL_EXPORT BaseSTFT* STFT_Create(bool splitComputation) {
         if (splitComputation) {
-            return new SFTF_SplitComputation();
+            return STFTImpl<true>::Create();
         } else {
-            return new STFT();
+            return STFTImpl<false>::Create();
         }
     }
 
-    DLL_EXPORT void STFT_Delete(BaseSTFT* stft) {
-        stft->reset();
-        delete stft;
-    }
-
-    DLL_EXPORT void STFT_Configure(BaseSTFT* stftBase, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry) {
-        stftBase->configure(inChannels, outChannels, blockSamples, extraInputHistory, intervalSamples, asymmetry);
-    }
-
-    DLL_EXPORT size_t STFT_BlockSamples(BaseSTFT* stftBase) {
-        return stftBase->blockSamples();
-    }
-
-    DLL_EXPORT size_t STFT_FFTSamples(BaseSTFT* stftBase) {
-        return stftBase->fftSamples();
-    }
-
-    DLL_EXPORT size_t STFT_Bands(BaseSTFT* stftBase) {
-        return stftBase->bands();
-    }
-
-    DLL_EXPORT void STFT_Reset(BaseSTFT* stftBase) {
-        stftBase->reset();
-    }
-
-    DLL_EXPORT void STFT_WriteInput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* inputArray) {
-        stftBase->writeInput(channel, offset, length, inputArray);
-    }
-
-    DLL_EXPORT void STFT_ReadOutput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, float* outputArray) {
-        stftBase->readOutput(channel, offset, length, outputArray);
-    }
-
-    DLL_EXPORT void STFT_MoveInput(BaseSTFT* stftBase, size_t samples, bool clearMovedRegion) {
-        stftBase->moveInput(samples, clearMovedRegion);
-    }
-
-    DLL_EXPORT void STFT_SetInterval(BaseSTFT* stftBase, size_t defaultInterval, STFTWindowShape windowShape, float asymmetry) {
-        stftBase->setInterval(defaultInterval, windowShape, asymmetry);
-    }
-
-    DLL_EXPORT void STFT_Analyse(BaseSTFT* stftBase, size_t sampleInPast) {
-        stftBase->analyse(sampleInPast);
-    }
-
-    DLL_EXPORT void STFT_Synthesise(BaseSTFT* stftBase) {
-        stftBase->synthesise();
-    }
-
-    DLL_EXPORT float* STFT_Spectrum(BaseSTFT* stftBase, size_t channel) {
-        std::complex<float>* spec = stftBase->spectrum(channel);
-        stftBase->complex[0] = spec->real();
-        stftBase->complex[1] = spec->imag();
-
-        return stftBase->complex;
-    }
-
-    DLL_EXPORT float* STFT_AnalysisWindow(BaseSTFT* stftBase) {
-        return stftBase->analysisWindow();
-    }
-
-    DLL_EXPORT float* STFT_SynthesisWindow(BaseSTFT* stftBase) {
-        return stftBase->synthesisWindow();
-    }
-
-    DLL_EXPORT size_t STFT_AnalysisLatency(BaseSTFT* stftBase) {
-        return stftBase->analysisLatency();
-    }
-
-    DLL_EXPORT size_t STFT_SynthesisLatency(BaseSTFT* stftBase) {
-        return stftBase->synthesisLatency();
-    }
-
-    DLL_EXPORT size_t STFT_Latency(BaseSTFT* stftBase) {
-        return stftBase->latency();
-    }
-
-    DLL_EXPORT float STFT_BinToFreq(BaseSTFT* stftBase, float b) {
-        return stftBase->binToFreq(b);
-    }
-
-    DLL_EXPORT float STFT_FreqToBin(BaseSTFT* stftBase, float f) {
-        return stftBase->freqToBin(f);
-    }
-
-    DLL_EXPORT size_t STFT_AnalyseSteps(BaseSTFT* stftBase) {
-        return stftBase->analyseSteps();
-    }
-
-    DLL_EXPORT size_t STFT_SynthesiseSteps(BaseSTFT* stftBase) {
-        return stftBase->synthesiseSteps();
-    }
-
-    DLL_EXPORT void STFT_AnalyseStep(BaseSTFT* stftBase, size_t step, size_t sampleInPast) {
-        stftBase->analyseStep(step, sampleInPast);
-    }
-
-    DLL_EXPORT void STFT_SynthesiseStep(BaseSTFT* stftBase, size_t step) {
-        stftBase->synthesiseStep(step);
-    }
-
-    DLL_EXPORT size_t STFT_SamplesSinceAnalysis(BaseSTFT* stftBase) {
-        return stftBase->samplesSinceAnalysis();
-    }
-
-    DLL_EXPORT size_t STFT_SamplesSinceSynthesis(BaseSTFT* stftBase) {
-        return stftBase->samplesSinceSynthesis();
-    }
-
-    DLL_EXPORT void STFT_FinishOutput(BaseSTFT* stftBase, float strength, size_t offset) {
-        stftBase->finishOutput(strength, offset);
-    }
-
-    DLL_EXPORT void STFT_AddOutput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* outputArray) {
-        stftBase->addOutput(channel, offset, length, outputArray);
+    DLL_EXPORT BaseSTFT* STFT_Plain_Create() {
+        return STFTImpl<false>::Create();
+    }
+
+    DLL_EXPORT BaseSTFT* STFT_Split_Create() {
+        return STFTImpl<true>::Create();
+    }
+
+    DLL_EXPORT bool STFT_IsSplit(BaseSTFT* stftBase) {
+        return stftBase->splitComputation;
+    }
+
+    // Allocations made through the binding's allocator for this STFT since its last STFT_Configure. Processing
+    // and the interleaved transfers use buffers sized on configure, so this should stay at zero.
+    DLL_EXPORT size_t STFT_AllocationsSinceConfigure(BaseSTFT* stftBase) {
+        return stftBase->allocations.load(std::memory_order_relaxed);
+    }
+
+    STFT_EXPORT(void, Delete, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(void, Configure, (BaseSTFT* stftBase, int inChannels, int outChannels, int blockSamples, int extraInputHistory, int intervalSamples, float asymmetry), (stftBase, inChannels, outChannels, blockSamples, extraInputHistory, intervalSamples, asymmetry))
+    STFT_EXPORT(size_t, BlockSamples, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, FFTSamples, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, DefaultInterval, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, Bands, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(void, Reset, (BaseSTFT* stftBase), (stftBase))
+    // Heap bytes held by the binding for this instance. The windows, FFT and sample buffers are allocated inside
+    // signalsmith-linear through the standard allocator, so they are not included.
+    STFT_EXPORT(size_t, MemoryFootprint, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(void, WriteInput, (BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* inputArray), (stftBase, channel, offset, length, inputArray))
+    STFT_EXPORT(void, ReadOutput, (BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, float* outputArray), (stftBase, channel, offset, length, outputArray))
+
+    // All channels at once, for the input (or output) channel count given to STFT_Configure
+    STFT_EXPORT(void, WriteInputInterleaved, (BaseSTFT* stftBase, size_t offset, size_t length, const float* interleavedInput), (stftBase, offset, length, interleavedInput))
+    STFT_EXPORT(void, WriteInputPlanar, (BaseSTFT* stftBase, size_t offset, size_t length, const float* const* inputs), (stftBase, offset, length, inputs))
+    STFT_EXPORT(void, ReadOutputInterleaved, (BaseSTFT* stftBase, size_t offset, size_t length, float* interleavedOutput), (stftBase, offset, length, interleavedOutput))
+    STFT_EXPORT(void, ReadOutputPlanar, (BaseSTFT* stftBase, size_t offset, size_t length, float* const* outputs), (stftBase, offset, length, outputs))
+    STFT_EXPORT(void, AddOutputInterleaved, (BaseSTFT* stftBase, size_t offset, size_t length, const float* interleavedOutput), (stftBase, offset, length, interleavedOutput))
+    STFT_EXPORT(void, AddOutputPlanar, (BaseSTFT* stftBase, size_t offset, size_t length, const float* const* outputs), (stftBase, offset, length, outputs))
+    STFT_EXPORT(void, ReplaceOutputInterleaved, (BaseSTFT* stftBase, size_t offset, size_t length, const float* interleavedOutput), (stftBase, offset, length, interleavedOutput))
+    STFT_EXPORT(void, ReplaceOutputPlanar, (BaseSTFT* stftBase, size_t offset, size_t length, const float* const* outputs), (stftBase, offset, length, outputs))
+
+    STFT_EXPORT(void, MoveInput, (BaseSTFT* stftBase, size_t samples, bool clearMovedRegion), (stftBase, samples, clearMovedRegion))
+    STFT_EXPORT(void, SetInterval, (BaseSTFT* stftBase, size_t defaultInterval, STFTWindowShape windowShape, float asymmetry), (stftBase, defaultInterval, windowShape, asymmetry))
+    STFT_EXPORT(void, Analyse, (BaseSTFT* stftBase, size_t sampleInPast), (stftBase, sampleInPast))
+    STFT_EXPORT(void, Synthesise, (BaseSTFT* stftBase), (stftBase))
+
+    // Copies bin 0 of a channel's spectrum into the handle; kept for compatibility, see STFT_SpectrumPtr
+    STFT_EXPORT(float*, Spectrum, (BaseSTFT* stftBase, size_t channel), (stftBase, channel))
+
+    // Live view of a channel's spectrum: STFT_Bands() interleaved (real, imaginary) pairs, valid until the next configure
+    STFT_EXPORT(float*, SpectrumPtr, (BaseSTFT* stftBase, size_t channel), (stftBase, channel))
+    STFT_EXPORT(void, ReadSpectrum, (BaseSTFT* stftBase, size_t channel, float* outputReal, float* outputImag), (stftBase, channel, outputReal, outputImag))
+    STFT_EXPORT(void, ReadSpectrumInterleaved, (BaseSTFT* stftBase, size_t channel, float* interleavedOutput), (stftBase, channel, interleavedOutput))
+    STFT_EXPORT(void, WriteSpectrum, (BaseSTFT* stftBase, size_t channel, const float* inputReal, const float* inputImag), (stftBase, channel, inputReal, inputImag))
+    STFT_EXPORT(void, WriteSpectrumInterleaved, (BaseSTFT* stftBase, size_t channel, const float* interleavedInput), (stftBase, channel, interleavedInput))
+
+    STFT_EXPORT(float*, AnalysisWindow, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(float*, SynthesisWindow, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, AnalysisLatency, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, SynthesisLatency, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, Latency, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(float, BinToFreq, (BaseSTFT* stftBase, float b), (stftBase, b))
+    STFT_EXPORT(float, FreqToBin, (BaseSTFT* stftBase, float f), (stftBase, f))
+    STFT_EXPORT(size_t, AnalyseSteps, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, SynthesiseSteps, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(void, AnalyseStep, (BaseSTFT* stftBase, size_t step, size_t sampleInPast), (stftBase, step, sampleInPast))
+    STFT_EXPORT(void, SynthesiseStep, (BaseSTFT* stftBase, size_t step), (stftBase, step))
+    STFT_EXPORT(size_t, SamplesSinceAnalysis, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(size_t, SamplesSinceSynthesis, (BaseSTFT* stftBase), (stftBase))
+    STFT_EXPORT(void, FinishOutput, (BaseSTFT* stftBase, float strength, size_t offset), (stftBase, strength, offset))
+    STFT_EXPORT(void, AddOutput, (BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* outputArray), (stftBase, channel, offset, length, outputArray))
+    STFT_EXPORT(void, ReplaceOutput, (BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* outputArray), (stftBase, channel, offset, length, outputArray))
+    STFT_EXPORT(void, MoveOutput, (BaseSTFT* stftBase, size_t samples), (stftBase, samples))
+    STFT_EXPORT(void, ProcessBlock, (BaseSTFT* stftBase, const float* input, size_t inputLength, float* output, size_t outputLength, STFTSpectralCallback callback, void* userData), (stftBase, input, inputLength, output, outputLength, callback, userData))
+    STFT_EXPORT(void, AnalysisOffset, (BaseSTFT* stftBase, size_t offset), (stftBase, offset))
+    STFT_EXPORT(void, SynthesisOffset, (BaseSTFT* stftBase, size_t offset), (stftBase, offset))
+
+    DLL_EXPORT STFTScheduler* STFTScheduler_Create(BaseSTFT* stftBase) {
+        STFTScheduler* scheduler = hookNew<STFTScheduler>();
+        scheduler->stft = stftBase;
+        return scheduler;
+    }
+
+    DLL_EXPORT void STFTScheduler_Delete(STFTScheduler* scheduler) {
+        hookDelete(scheduler);
+    }
+
+    // intervalSamples is the hop size (0 uses the STFT's default interval), and callbackSamples the expected
+    // length of each STFTScheduler_Process call, used for the report. Call after STFT_Configure.
+    // Each hop is analysed up to one interval after it started, so STFT_Configure must have been given an
+    // extraInputHistory of at least the interval. Returns false if not, and STFTScheduler_Process then outputs silence.
+    DLL_EXPORT bool STFTScheduler_Configure(STFTScheduler* scheduler, size_t intervalSamples, size_t callbackSamples) {
+        BaseSTFT* stftBase = scheduler->stft;
+        scheduler->interval = intervalSamples ? intervalSamples : STFT_DefaultInterval(stftBase);
+        scheduler->callbackSamples = callbackSamples;
+        scheduler->position = 0;
+        scheduler->stepsDone = 0;
+
+        STFTScheduleReport& report = scheduler->report;
+        report = STFTScheduleReport();
+        report.stepsPerHop = stftBase->splitComputation ? STFTImpl<true>::StepsPerHop(stftBase) : STFTImpl<false>::StepsPerHop(stftBase);
+        if (scheduler->interval > 0) {
+            report.expectedSteps = (int)((report.stepsPerHop * callbackSamples + scheduler->interval - 1) / scheduler->interval);
+        }
+        return scheduler->interval > 0 && scheduler->interval <= (size_t)stftBase->extraInputHistory;
     }
 
-    DLL_EXPORT void STFT_ReplaceOutput(BaseSTFT* stftBase, size_t channel, size_t offset, size_t length, const float* outputArray) {
-        stftBase->replaceOutput(channel, offset, length, outputArray);
-    }
+    // Processes `length` interleaved samples, running the due share of the hop schedule (see STFTScheduler)
+    DLL_EXPORT void STFTScheduler_Process(STFTScheduler* scheduler, const float* input, float* output, size_t length, STFTSpectralCallback callback, void* userData) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (scheduler->stft->splitComputation) {
+            STFTImpl<true>::Schedule(scheduler, input, output, length, callback, userData);
+        } else {
+            STFTImpl<false>::Schedule(scheduler, input, output, length, callback, userData);
+        }
 
-    DLL_EXPORT void STFT_MoveOutput(BaseSTFT* stftBase, size_t samples) {
-        stftBase->moveOutput(samples);
+        STFTScheduleReport& report = scheduler->report;
+        report.microseconds = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+        report.maxMicroseconds = std::max(report.maxMicroseconds, report.microseconds);
+        report.maxStepsRun = std::max(report.maxStepsRun, report.stepsRun);
     }
 
-    DLL_EXPORT void STFT_AnalysisOffset(BaseSTFT* stftBase, size_t offset) {
-        stftBase->analysisOffset(offset);
+    // The STFT's latency plus the one interval the scheduler adds
+    DLL_EXPORT size_t STFTScheduler_Latency(STFTScheduler* scheduler) {
+        return STFT_Latency(scheduler->stft) + scheduler->interval;
     }
 
-    DLL_EXPORT void STFT_SynthesisOffset(BaseSTFT* stftBase, size_t offset) {
-        stftBase->synthesisOffset(offset);
+    DLL_EXPORT void STFTScheduler_Report(STFTScheduler* scheduler, STFTScheduleReport* report) {
+        *report = scheduler->report;
     }
 }
\ No newline at end of file
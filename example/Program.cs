@@ -9,7 +9,7 @@ public static class Program
 {
     static Stretch? Stretch;
     static unsafe ma_decoder* Decoder = null;
-    static readonly float[] stretchBuffer = new float[4096];
+    static volatile bool DecoderEnded = false;
 
     public static void Main(string[] args)
     {
@@ -60,6 +60,8 @@ public static class Program
 
             Stretch = new Stretch();
             Stretch.PresetDefault(2, 44100.0f, true);
+            Stretch.RenderStart(&ReadDecoder, null);
+            Stretch.SetRenderRate(1.5); // Stretch factor
 
             Decoder = decoder;
 
@@ -86,26 +88,32 @@ public static class Program
 
         Span<float> outputBuffer = new(output, (int)(frameCount * device->playback.channels));
 
-        float rate = 1.5f; // Stretch factor
-        uint frameCountToRead = (uint)(frameCount * rate);
+        // Pulls exactly the input this block needs through ReadDecoder
+        Stretch.Render(outputBuffer, (int)frameCount);
 
+        if (DecoderEnded)
+        {
+            ma.device_stop(device);
+        }
+    }
+
+    [UnmanagedCallersOnly]
+    public static unsafe int ReadDecoder(void* userData, float* buffer, int frames)
+    {
         ulong framesRead;
-        fixed (float* pOutputBuffer = stretchBuffer)
+        ma_result result = ma.decoder_read_pcm_frames(Decoder, buffer, (ulong)frames, &framesRead);
+        if (result != ma_result.MA_SUCCESS)
         {
-            ma_result result = ma.decoder_read_pcm_frames(Decoder, pOutputBuffer, frameCountToRead, &framesRead);
-            if (result != ma_result.MA_SUCCESS)
+            if (result == ma_result.MA_AT_END)
+            {
+                DecoderEnded = true;
+            }
+            else
             {
-                if (result == ma_result.MA_AT_END)
-                {
-                    ma.device_stop(device);
-                }
-                else
-                {
-                    throw new Exception("Failed to read PCM frames from decoder.");
-                }
+                throw new Exception("Failed to read PCM frames from decoder.");
             }
         }
 
-        Stretch.Process(stretchBuffer, (int)frameCountToRead, outputBuffer, (int)frameCount);
+        return (int)framesRead;
     }
 }
\ No newline at end of file